@@ -2401,12 +2401,30 @@ getnextac(
  */
     int
 has_autocmd(event_T event, char_u *sfname, buf_T *buf)
+{
+    return has_autocmd_skip_group(event, sfname, buf, NULL);
+}
+
+/*
+ * Like has_autocmd(), but ignore the autocommands in group "skip_group", if
+ * it is not NULL.
+ */
+    int
+has_autocmd_skip_group(
+    event_T	event,
+    char_u	*sfname,
+    buf_T	*buf,
+    char_u	*skip_group)
 {
     AutoPat	*ap;
     char_u	*fname;
     char_u	*tail = gettail(sfname);
+    int		skip_id = AUGROUP_ERROR;
     int		retval = FALSE;
 
+    if (skip_group != NULL)
+	skip_id = au_find_group(skip_group);
+
     fname = FullName_save(sfname, FALSE);
     if (fname == NULL)
 	return FALSE;
@@ -2424,6 +2442,7 @@ has_autocmd(event_T event, char_u *sfname, buf_T *buf)
 
     FOR_ALL_AUTOCMD_PATTERNS(event, ap)
 	if (ap->pat != NULL && ap->cmds != NULL
+	      && ap->group != skip_id
 	      && (ap->buflocal_nr == 0
 		? match_file_pat(NULL, &ap->reg_prog,
 					  fname, sfname, tail, ap->allow_dirs)
@@ -888,6 +888,9 @@ buf_freeall(buf_T *buf, int flags)
     }
 #endif
 
+#if defined(FEAT_SYN_HL) && defined(FEAT_PERSISTENT_UNDO)
+    syn_cache_write(buf);	    // keep the syntax states for the text
+#endif
 #ifdef FEAT_TCL
     tcl_buffer_free(buf);
 #endif
@@ -18,6 +18,7 @@
 #endif
 
 #define SMALLBUFSIZE	256	// size of emergency write buffer
+#define LARGEBUFSIZE	65536	// size of write buffer when not encrypting
 
 /*
  * Structure to pass arguments from buf_write() to buf_write_bytes().
@@ -209,6 +210,18 @@ buf_write_bytes(struct bw_info *ip)
 			n = 0;
 		    }
 		}
+		else if ((flags & FIO_LATIN1) && buf[wlen] < 0x80)
+		{
+		    // Fast path: ASCII does not change, copy all of it.
+		    for (n = 0; wlen + n < len && buf[wlen + n] < 0x80; ++n)
+		    {
+			if (buf[wlen + n] == NL)
+			    ++ip->bw_start_lnum;
+			p[n] = buf[wlen + n];
+		    }
+		    p += n;
+		    continue;
+		}
 		else
 		{
 		    n = utf_ptr2len_len(buf + wlen, len - wlen);
@@ -646,6 +659,8 @@ buf_write(
     char_u	    *s;
     char_u	    *ptr;
     char_u	    c;
+    int		    n;
+    int		    linelen;
     int		    len;
     linenr_T	    lnum;
     long	    nchars;
@@ -1024,7 +1039,15 @@ buf_write(
 		    (char_u *)"", 0);	// show that we are busy
     msg_scroll = FALSE;		    // always overwrite the file message now
 
-    buffer = alloc(WRITEBUFSIZE);
+    // Use a large buffer to reduce the number of system calls.  When
+    // encrypting the text is read back in blocks of WRITEBUFSIZE, thus it
+    // must be written in blocks of that size.
+    bufsize = LARGEBUFSIZE;
+#ifdef FEAT_CRYPT
+    if (*buf->b_p_key != NUL)
+	bufsize = WRITEBUFSIZE;
+#endif
+    buffer = alloc(bufsize);
     if (buffer == NULL)		    // can't allocate big buffer, use small
 				    // one (to be able to write when out of
 				    // memory)
@@ -1032,8 +1055,6 @@ buf_write(
 	buffer = smallbuf;
 	bufsize = SMALLBUFSIZE;
     }
-    else
-	bufsize = WRITEBUFSIZE;
 
     // Get information about original file (if there is one).
 #if defined(UNIX)
@@ -2008,30 +2029,51 @@ restore_backup:
 	len = 0;
 	for (lnum = start; lnum <= end; ++lnum)
 	{
-	    // The next while loop is done once for each character written.
-	    // Keep it fast!
-	    ptr = ml_get_buf(buf, lnum, FALSE) - 1;
+	    int	    last_no_eol;    // last line, written without an EOL
+
+	    ptr = ml_get_buf(buf, lnum, FALSE);
+	    linelen = ml_get_buf_len(buf, lnum);
+	    last_no_eol = lnum == end
+			&& (write_bin || !buf->b_p_fixeol)
+			&& ((write_bin && lnum == buf->b_no_eol_lnum)
+			    || (lnum == buf->b_ml.ml_line_count
+							   && !buf->b_p_eol));
 #ifdef FEAT_PERSISTENT_UNDO
 	    if (write_undo_file)
-		sha256_update(&sha_ctx, ptr + 1,
-					      (UINT32_T)(STRLEN(ptr + 1) + 1));
+		sha256_update(&sha_ctx, ptr, (UINT32_T)(linelen + 1));
 #endif
-	    while ((c = *++ptr) != NUL)
+	    // The next while loop is done once for each part of the line that
+	    // fits in the buffer.  Copy the text as a whole and then fix the
+	    // few special characters.  Keep it fast!
+	    while (linelen > 0)
 	    {
-		if (c == NL)
-		    *s = NUL;		// replace newlines with NULs
-		else if (c == CAR && fileformat == EOL_MAC)
-		    *s = NL;		// Mac: replace CRs with NLs
-		else
-		    *s = c;
-		++s;
-		if (++len != bufsize)
+		char_u	*p;
+
+		n = bufsize - len;
+		if (n > linelen)
+		    n = linelen;
+		mch_memmove(s, ptr, (size_t)n);
+		// replace newlines with NULs
+		for (p = memchr(s, NL, (size_t)n); p != NULL;
+				  p = memchr(p + 1, NL, (size_t)(s + n - p - 1)))
+		    *p = NUL;
+		// Mac: replace CRs with NLs
+		if (fileformat == EOL_MAC)
+		    for (p = memchr(s, CAR, (size_t)n); p != NULL;
+				 p = memchr(p + 1, CAR, (size_t)(s + n - p - 1)))
+			*p = NL;
+		s += n;
+		ptr += n;
+		linelen -= n;
+		len += n;
+		if (len != bufsize)
 		    continue;
 #ifdef FEAT_CRYPT
-		if (write_info.bw_fd > 0 && lnum == end
+		// Finish when nothing follows, not even an EOL.
+		if (write_info.bw_fd > 0 && last_no_eol
 			&& (write_info.bw_flags & FIO_ENCRYPTED)
 			&& *buf->b_p_key != NUL && !filtering
-			&& *ptr == NUL)
+			&& linelen == 0)
 		    write_info.bw_finish = TRUE;
  #endif
 		if (buf_write_bytes(&write_info) == FAIL)
@@ -2045,12 +2087,7 @@ restore_backup:
 		write_info.bw_start_lnum = lnum;
 	    }
 	    // write failed or last line has no EOL: stop here
-	    if (end == 0
-		    || (lnum == end
-			&& (write_bin || !buf->b_p_fixeol)
-			&& ((write_bin && lnum == buf->b_no_eol_lnum)
-			    || (lnum == buf->b_ml.ml_line_count
-							   && !buf->b_p_eol))))
+	    if (end == 0 || last_no_eol)
 	    {
 		++lnum;			// written the line, count it
 		no_eol = TRUE;
@@ -2079,6 +2116,13 @@ restore_backup:
 	    }
 	    if (++len == bufsize && end)
 	    {
+#ifdef FEAT_CRYPT
+		// The EOL of the last line fills the buffer, nothing follows.
+		if (write_info.bw_fd > 0 && lnum == end
+			&& (write_info.bw_flags & FIO_ENCRYPTED)
+			&& *buf->b_p_key != NUL && !filtering)
+		    write_info.bw_finish = TRUE;
+#endif
 		if (buf_write_bytes(&write_info) == FAIL)
 		{
 		    end = 0;		// write error: break loop
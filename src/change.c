@@ -443,6 +443,10 @@ changed_common(
 
     // mark the buffer as modified
     changed();
+#if defined(FEAT_SYN_HL) && defined(FEAT_PERSISTENT_UNDO)
+    // The text no longer matches the undo file.
+    curbuf->b_syn_cache_hash_ok = FALSE;
+#endif
 
 #ifdef FEAT_EVAL
     may_record_change(lnum, col, lnume, xtra);
@@ -1287,8 +1291,10 @@ del_bytes(
     mch_memmove(newp + col, oldp + col + count, (size_t)movelen);
     if (alloc_newp)
 	ml_replace(lnum, newp, FALSE);
-#ifdef FEAT_PROP_POPUP
     else
+	curbuf->b_ml.ml_line_textlen = newlen + 1;
+#ifdef FEAT_PROP_POPUP
+    if (!alloc_newp)
     {
 	// Also move any following text properties.
 	if (oldlen + 1 < curbuf->b_ml.ml_line_len)
@@ -1771,6 +1771,7 @@ set_one_cmd_context(
 	    break;
 #if defined(FEAT_PROFILE)
 	case CMD_syntime:
+	case CMD_regexptime:
 	    xp->xp_context = EXPAND_SYNTIME;
 	    xp->xp_pattern = arg;
 	    break;
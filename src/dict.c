@@ -19,6 +19,8 @@
 // from partial to dict to partial, we don't need to keep track of the partial,
 // since it will get freed when the dict is unused and gets freed.
 static dict_T		*first_dict = NULL;
+static dict_T		*first_old_dict = NULL;	// dicts from here on existed
+						// at the last collection
 
 /*
  * Allocate an empty header for a dictionary.
@@ -146,6 +148,8 @@ hashtab_free_contents(hashtab_T *ht)
 dict_free_dict(dict_T *d)
 {
     // Remove the dict from the list of dicts for garbage collection.
+    if (d == first_old_dict)
+	first_old_dict = d->dv_used_next;
     if (d->dv_used_prev == NULL)
 	first_dict = d->dv_used_next;
     else
@@ -178,13 +182,13 @@ dict_unref(dict_T *d)
 
 /*
  * Go through the list of dicts and free items without the copyID.
- * Returns TRUE if something was freed.
+ * Returns the number of dicts that were emptied.
  */
     int
 dict_free_nonref(int copyID)
 {
     dict_T	*dd;
-    int		did_free = FALSE;
+    int		count = 0;
 
     for (dd = first_dict; dd != NULL; dd = dd->dv_used_next)
 	if ((dd->dv_copyID & COPYID_MASK) != (copyID & COPYID_MASK))
@@ -193,22 +197,91 @@ dict_free_nonref(int copyID)
 	    // recurse into Lists and Dictionaries, they will be in the list
 	    // of dicts or list of lists.
 	    dict_free_contents(dd);
-	    did_free = TRUE;
+	    ++count;
 	}
-    return did_free;
+    return count;
 }
 
-    void
+/*
+ * Free the dicts emptied by dict_free_nonref().
+ * Returns the number of dicts that are still in use.
+ */
+    int
 dict_free_items(int copyID)
 {
     dict_T	*dd, *dd_next;
+    int		count = 0;
 
     for (dd = first_dict; dd != NULL; dd = dd_next)
     {
 	dd_next = dd->dv_used_next;
 	if ((dd->dv_copyID & COPYID_MASK) != (copyID & COPYID_MASK))
 	    dict_free_dict(dd);
+	else
+	    ++count;
+    }
+    return count;
+}
+
+/*
+ * Add the dicts created since the last garbage collection to "gap", as a
+ * typval, and mark them with "copyID".  New dicts are inserted at the start
+ * of "first_dict", these are the ones before "first_old_dict".
+ * Returns FAIL when out of memory.
+ */
+    int
+dict_add_young(garray_T *gap, int copyID)
+{
+    dict_T	*dd;
+    typval_T	*tv;
+
+    for (dd = first_dict; dd != first_old_dict; dd = dd->dv_used_next)
+    {
+	if (ga_grow(gap, 1) == FAIL)
+	    return FAIL;
+	tv = ((typval_T *)gap->ga_data) + gap->ga_len++;
+	tv->v_type = VAR_DICT;
+	tv->vval.v_dict = dd;
+	dd->dv_copyID = copyID;
+    }
+    return OK;
+}
+
+/*
+ * Called at the end of a garbage collection: all existing dicts are old now.
+ */
+    void
+dict_make_old(void)
+{
+    first_old_dict = first_dict;
+}
+
+/*
+ * Free the dicts in "gap" that are still marked with "copyID", they are not
+ * referenced.  When "contents" is TRUE only free the items, like
+ * dict_free_nonref(), otherwise free the dicts themselves.
+ * Returns the number of dicts.
+ */
+    int
+dict_free_young(garray_T *gap, int copyID, int contents)
+{
+    typval_T	*tv;
+    int		i;
+    int		count = 0;
+
+    for (i = 0; i < gap->ga_len; ++i)
+    {
+	tv = ((typval_T *)gap->ga_data) + i;
+	if (tv->v_type == VAR_DICT && tv->vval.v_dict->dv_copyID == copyID)
+	{
+	    if (contents)
+		dict_free_contents(tv->vval.v_dict);
+	    else
+		dict_free_dict(tv->vval.v_dict);
+	    ++count;
+	}
     }
+    return count;
 }
 
 /*
@@ -413,6 +486,30 @@ dict_add_bool(dict_T *d, char *key, varnumber_T nr)
     return dict_add_number_special(d, key, nr, VAR_BOOL);
 }
 
+#if defined(FEAT_FLOAT) || defined(PROTO)
+/*
+ * Add a float entry to dictionary "d".
+ * Returns FAIL when out of memory and when key already exists.
+ */
+    int
+dict_add_float(dict_T *d, char *key, float_T nr)
+{
+    dictitem_T	*item;
+
+    item = dictitem_alloc((char_u *)key);
+    if (item == NULL)
+	return FAIL;
+    item->di_tv.v_type = VAR_FLOAT;
+    item->di_tv.vval.v_float = nr;
+    if (dict_add(d, item) == FAIL)
+    {
+	dictitem_free(item);
+	return FAIL;
+    }
+    return OK;
+}
+#endif
+
 /*
  * Add a string entry to dictionary "d".
  * Returns FAIL when out of memory and when key already exists.
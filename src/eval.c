@@ -29,6 +29,24 @@
  */
 static int current_copyID = 0;
 
+/*
+ * Statistics for garbage collection, see garbagecollect_info().
+ * A young collection only checks the lists and dicts created since the last
+ * collection.  Those that survive it are "promoted", a full collection is
+ * done when too many were promoted.
+ */
+static long	gc_full_count = 0;	// number of full collections
+static long	gc_young_count = 0;	// number of young collections
+static long	gc_full_freed = 0;	// lists and dicts freed by full ones
+static long	gc_young_freed = 0;	// lists and dicts freed by young ones
+static long	gc_old = 0;		// survived the last full collection
+static long	gc_promoted = 0;	// survived young collections since
+#if defined(FEAT_RELTIME) && defined(FEAT_FLOAT)
+static float_T	gc_full_time = 0;	// total time of full collections
+static float_T	gc_young_time = 0;	// total time of young collections
+static float_T	gc_max_time = 0;	// longest collection
+#endif
+
 /*
  * Info used by a ":for" loop.
  */
@@ -2990,8 +3008,23 @@ eval5(char_u **arg, typval_T *rettv, evalarg_T *evalarg)
 		    clear_tv(&var2);
 		    return FAIL;
 		}
-		p = concat_str(s1, s2);
-		clear_tv(rettv);
+		if (rettv->v_type == VAR_STRING && rettv->vval.v_string != NULL)
+		{
+		    size_t len1 = STRLEN(s1);
+
+		    // "rettv" owns the string, make it longer instead of
+		    // allocating a new one.  Helps for "a .. b .. c".
+		    p = vim_realloc(s1, len1 + STRLEN(s2) + 1);
+		    if (p == NULL)
+			clear_tv(rettv);
+		    else
+			STRCPY(p + len1, s2);
+		}
+		else
+		{
+		    p = concat_str(s1, s2);
+		    clear_tv(rettv);
+		}
 		rettv->v_type = VAR_STRING;
 		rettv->vval.v_string = p;
 	    }
@@ -4409,6 +4442,23 @@ get_copyID(void)
  *	http://python.ca/nas/python/gc/
  */
 
+#if defined(FEAT_RELTIME) && defined(FEAT_FLOAT)
+/*
+ * Add the time since "start" to "total" and remember the longest time.
+ */
+    static void
+gc_add_time(proftime_T *start, float_T *total)
+{
+    float_T time;
+
+    profile_end(start);
+    time = profile_float(start);
+    *total += time;
+    if (time > gc_max_time)
+	gc_max_time = time;
+}
+#endif
+
 /*
  * Do garbage collection for lists and dicts.
  * When "testing" is TRUE this is called from test_garbagecollect_now().
@@ -4423,6 +4473,11 @@ garbage_collect(int testing)
     win_T	*wp;
     int		did_free = FALSE;
     tabpage_T	*tp;
+#if defined(FEAT_RELTIME) && defined(FEAT_FLOAT)
+    proftime_T	start;
+
+    profile_start(&start);
+#endif
 
     if (!testing)
     {
@@ -4571,9 +4626,247 @@ garbage_collect(int testing)
 	verb_msg(_("Not enough memory to set references, garbage collection aborted!"));
     }
 
+    ++gc_full_count;
+#if defined(FEAT_RELTIME) && defined(FEAT_FLOAT)
+    gc_add_time(&start, &gc_full_time);
+#endif
     return did_free;
 }
 
+/*
+ * Handle a reference from a young list or dict to "tv" for
+ * garbage_collect_young().  Young lists and dicts are marked with
+ * "young_copyID", or "keep_copyID" once found to be in use.
+ * When "stack" is NULL add "delta" to the reference count of a young list or
+ * dict.  Otherwise mark a young list or dict with "keep_copyID" and push it
+ * on "stack", unless that was already done.
+ * Returns FAIL when out of memory.
+ */
+    static int
+young_ref(
+	typval_T    *tv,
+	int	    young_copyID,
+	int	    keep_copyID,
+	int	    delta,
+	garray_T    *stack)
+{
+    int	    *copyIDp;
+    int	    *refcountp;
+
+    if (tv->v_type == VAR_LIST && tv->vval.v_list != NULL)
+    {
+	copyIDp = &tv->vval.v_list->lv_copyID;
+	refcountp = &tv->vval.v_list->lv_refcount;
+    }
+    else if (tv->v_type == VAR_DICT && tv->vval.v_dict != NULL)
+    {
+	copyIDp = &tv->vval.v_dict->dv_copyID;
+	refcountp = &tv->vval.v_dict->dv_refcount;
+    }
+    else
+	return OK;
+
+    if (stack == NULL)
+    {
+	if (*copyIDp == young_copyID || *copyIDp == keep_copyID)
+	    *refcountp += delta;
+    }
+    else if (*copyIDp == young_copyID)
+    {
+	if (ga_grow(stack, 1) == FAIL)
+	    return FAIL;
+	*copyIDp = keep_copyID;
+	((typval_T *)stack->ga_data)[stack->ga_len++] = *tv;
+    }
+    return OK;
+}
+
+/*
+ * Call young_ref() for each item in the list or dict "tv".
+ */
+    static int
+young_ref_items(
+	typval_T    *tv,
+	int	    young_copyID,
+	int	    keep_copyID,
+	int	    delta,
+	garray_T    *stack)
+{
+    if (tv->v_type == VAR_LIST)
+    {
+	list_T	    *l = tv->vval.v_list;
+	listitem_T  *li;
+
+	if (l->lv_first != &range_list_item)
+	    FOR_ALL_LIST_ITEMS(l, li)
+		if (young_ref(&li->li_tv, young_copyID, keep_copyID,
+							 delta, stack) == FAIL)
+		    return FAIL;
+    }
+    else
+    {
+	hashtab_T   *ht = &tv->vval.v_dict->dv_hashtab;
+	hashitem_T  *hi;
+	int	    todo = (int)ht->ht_used;
+
+	for (hi = ht->ht_array; todo > 0; ++hi)
+	    if (!HASHITEM_EMPTY(hi))
+	    {
+		--todo;
+		if (young_ref(&HI2DI(hi)->di_tv, young_copyID, keep_copyID,
+							 delta, stack) == FAIL)
+		    return FAIL;
+	    }
+    }
+    return OK;
+}
+
+/*
+ * Garbage collection for the lists and dicts created since the last
+ * collection, the young ones.  Most lists and dicts are short-lived, thus
+ * this finds most garbage while the time it takes does not depend on how
+ * many lists and dicts exist in total.
+ *
+ * Instead of marking everything reachable from variables, this uses the
+ * reference counts: references from one young item to another are
+ * subtracted, a young item whose count is still above zero is referenced
+ * from elsewhere and is in use, like everything it refers to.  The other
+ * young items are only referenced from each other and can be freed.
+ * Lists and dicts that are not young, partials, functions, etc. are not
+ * looked into, what they refer to is kept.  That garbage is found by
+ * garbage_collect().
+ *
+ * Return TRUE if some memory was freed.
+ */
+    int
+garbage_collect_young(void)
+{
+    garray_T	young;
+    garray_T	stack;
+    typval_T	*tv;
+    int		young_copyID;
+    int		keep_copyID;
+    int		refcount;
+    int		abort = FALSE;
+    int		freed = 0;
+    int		i;
+#if defined(FEAT_RELTIME) && defined(FEAT_FLOAT)
+    proftime_T	start;
+
+    profile_start(&start);
+#endif
+
+    young_copyID = get_copyID();
+    keep_copyID = get_copyID();
+    ga_init2(&young, sizeof(typval_T), 500);
+    ga_init2(&stack, sizeof(typval_T), 100);
+
+    // 1. Find the young lists and dicts.  When out of memory halfway the ones
+    //    that were not added are not young.
+    if (list_add_young(&young, young_copyID) == OK)
+	(void)dict_add_young(&young, young_copyID);
+
+    // 2. Subtract the references from young items.
+    for (i = 0; i < young.ga_len; ++i)
+	(void)young_ref_items(((typval_T *)young.ga_data) + i,
+					   young_copyID, keep_copyID, -1, NULL);
+
+    // 3. Keep the young items that are referenced from elsewhere and what
+    //    they refer to.  A list with a watcher is in use.
+    for (i = 0; !abort && i < young.ga_len; ++i)
+    {
+	tv = ((typval_T *)young.ga_data) + i;
+	refcount = tv->v_type == VAR_LIST ? tv->vval.v_list->lv_refcount
+					  : tv->vval.v_dict->dv_refcount;
+	if (refcount > 0 || (tv->v_type == VAR_LIST
+				       && tv->vval.v_list->lv_watch != NULL))
+	    abort = young_ref(tv, young_copyID, keep_copyID, 0, &stack)
+									== FAIL;
+	while (!abort && stack.ga_len > 0)
+	{
+	    typval_T	item = ((typval_T *)stack.ga_data)[--stack.ga_len];
+
+	    abort = young_ref_items(&item, young_copyID, keep_copyID, 0,
+							       &stack) == FAIL;
+	}
+    }
+
+    // 4. Restore the reference counts.
+    for (i = 0; i < young.ga_len; ++i)
+	(void)young_ref_items(((typval_T *)young.ga_data) + i,
+					   young_copyID, keep_copyID, 1, NULL);
+
+    // 5. Free the young items that were not kept, like free_unref_items().
+    if (!abort)
+    {
+	in_free_unref_items = TRUE;
+	dict_free_young(&young, young_copyID, TRUE);
+	list_free_young(&young, young_copyID, TRUE);
+	freed = dict_free_young(&young, young_copyID, FALSE)
+			       + list_free_young(&young, young_copyID, FALSE);
+	in_free_unref_items = FALSE;
+	gc_young_freed += freed;
+	gc_promoted += young.ga_len - freed;
+    }
+    else
+    {
+	// Keep everything, the young items are not looked at again.
+	gc_promoted += young.ga_len;
+	if (p_verbose > 0)
+	    verb_msg(_("Not enough memory to set references, garbage collection aborted!"));
+    }
+    list_make_old();
+    dict_make_old();
+
+    ga_clear(&young);
+    ga_clear(&stack);
+    ++gc_young_count;
+#if defined(FEAT_RELTIME) && defined(FEAT_FLOAT)
+    gc_add_time(&start, &gc_young_time);
+#endif
+    return freed > 0;
+}
+
+/*
+ * Garbage collection when waiting for the user to type a character.  Usually
+ * only the young lists and dicts are checked.  A full collection is done
+ * when garbagecollect() was called or when more lists and dicts were
+ * promoted than a quarter of what survived the last full collection.  Thus
+ * the time spent on marking everything is spread out over many collections,
+ * also with a large number of long-lived lists and dicts.
+ */
+    void
+garbage_collect_idle(void)
+{
+    if (want_garbage_collect || gc_promoted > gc_old / 4)
+	(void)garbage_collect(FALSE);
+    else
+    {
+	// Only do this once.
+	may_garbage_collect = FALSE;
+	(void)garbage_collect_young();
+    }
+}
+
+/*
+ * Add the garbage collection statistics to dict "d".
+ */
+    void
+garbage_collect_info(dict_T *d)
+{
+    dict_add_number(d, "full", gc_full_count);
+    dict_add_number(d, "young", gc_young_count);
+    dict_add_number(d, "full_freed", gc_full_freed);
+    dict_add_number(d, "young_freed", gc_young_freed);
+    dict_add_number(d, "old", gc_old);
+    dict_add_number(d, "promoted", gc_promoted);
+#if defined(FEAT_RELTIME) && defined(FEAT_FLOAT)
+    dict_add_float(d, "full_time", gc_full_time);
+    dict_add_float(d, "young_time", gc_young_time);
+    dict_add_float(d, "max_time", gc_max_time);
+#endif
+}
+
 /*
  * Free lists, dictionaries, channels and jobs that are no longer referenced.
  */
@@ -4581,6 +4874,7 @@ garbage_collect(int testing)
 free_unref_items(int copyID)
 {
     int		did_free = FALSE;
+    int		freed;
 
     // Let all "free" functions know that we are here.  This means no
     // dictionaries, lists, channels or jobs are to be freed, because we will
@@ -4593,10 +4887,12 @@ free_unref_items(int copyID)
      */
 
     // Go through the list of dicts and free items without the copyID.
-    did_free |= dict_free_nonref(copyID);
+    freed = dict_free_nonref(copyID);
 
     // Go through the list of lists and free items without the copyID.
-    did_free |= list_free_nonref(copyID);
+    freed += list_free_nonref(copyID);
+    did_free = freed > 0;
+    gc_full_freed += freed;
 
 #ifdef FEAT_JOB_CHANNEL
     // Go through the list of jobs and free items without the copyID. This
@@ -4611,8 +4907,10 @@ free_unref_items(int copyID)
     /*
      * PASS 2: free the items themselves.
      */
-    dict_free_items(copyID);
-    list_free_items(copyID);
+    gc_old = dict_free_items(copyID) + list_free_items(copyID);
+    gc_promoted = 0;
+    list_make_old();
+    dict_make_old();
 
 #ifdef FEAT_JOB_CHANNEL
     // Go through the list of jobs and free items without the copyID. This
@@ -5307,7 +5605,7 @@ var2fpos(
 	if (charcol)
 	    len = (long)mb_charlen(ml_get(pos.lnum));
 	else
-	    len = (long)STRLEN(ml_get(pos.lnum));
+	    len = (long)ml_get_len(pos.lnum);
 
 	// Get the column number
 	// We accept "$" for the column number: last column.
@@ -5405,7 +5703,7 @@ var2fpos(
 	    if (charcol)
 		pos.col = (colnr_T)mb_charlen(ml_get_curline());
 	    else
-		pos.col = (colnr_T)STRLEN(ml_get_curline());
+		pos.col = ml_get_curline_len();
 	}
 	return &pos;
     }
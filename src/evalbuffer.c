@@ -556,6 +556,22 @@ get_buffer_info(buf_T *buf)
     dict_add_number(dict, "hidden",
 			    buf->b_ml.ml_mfp != NULL && buf->b_nwindows == 0);
 
+    if (buf->b_ml.ml_mfp != NULL)
+    {
+	dict_T	*mf_dict = dict_alloc();
+
+	// Statistics of the memfile holding the text
+	if (mf_dict != NULL)
+	{
+	    dict_add_number(mf_dict, "blocks", buf->b_ml.ml_mfp->mf_used_count);
+	    dict_add_number(mf_dict, "hits", buf->b_ml.ml_mfp->mf_hits);
+	    dict_add_number(mf_dict, "misses", buf->b_ml.ml_mfp->mf_misses);
+	    dict_add_number(mf_dict, "evictions",
+					       buf->b_ml.ml_mfp->mf_evictions);
+	    dict_add_dict(dict, "memfile", mf_dict);
+	}
+    }
+
     // Get a reference to buffer variables
     dict_add_dict(dict, "variables", buf->b_vars);
 
@@ -163,6 +163,9 @@ static void	ex_popup(exarg_T *eap);
 #if !defined(FEAT_SYN_HL) || !defined(FEAT_PROFILE)
 # define ex_syntime		ex_ni
 #endif
+#ifndef FEAT_PROFILE
+# define ex_regexptime		ex_ni
+#endif
 #ifndef FEAT_SPELL
 # define ex_spell		ex_ni
 # define ex_mkspell		ex_ni
@@ -7862,7 +7865,7 @@ ex_wundo(exarg_T *eap)
 {
     char_u hash[UNDO_HASH_SIZE];
 
-    u_compute_hash(hash);
+    u_compute_hash(curbuf, hash);
     u_write_undo(eap->arg, eap->forceit, curbuf, hash);
 }
 
@@ -7871,7 +7874,7 @@ ex_rundo(exarg_T *eap)
 {
     char_u hash[UNDO_HASH_SIZE];
 
-    u_compute_hash(hash);
+    u_compute_hash(curbuf, hash);
     u_read_undo(eap->arg, hash, NULL);
 }
 #endif
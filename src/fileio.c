@@ -31,6 +31,9 @@
 // Is there any system that doesn't have access()?
 #define USE_MCH_ACCESS
 
+// Number of lines readfile() collects before appending them to the buffer.
+#define READ_BATCH_LINES 100
+
 #if defined(__hpux) && !defined(HAVE_DIRFD)
 # define dirfd(x) ((x)->__dd_fd)
 # define HAVE_DIRFD
@@ -44,6 +47,7 @@ static char_u *readfile_charconvert(char_u *fname, char_u *fenc, int *fdp);
 static char_u *check_for_cryptkey(char_u *cryptkey, char_u *ptr, long *sizep, off_T *filesizep, int newfile, char_u *fname, int *did_ask);
 #endif
 static linenr_T readfile_linenr(linenr_T linecnt, char_u *p, char_u *endp);
+static int readfile_append(linenr_T lnum, char_u **lines, colnr_T *lens, int *countp, int newfile);
 static char_u *check_for_bom(char_u *p, long size, int *lenp, int flags);
 static char *e_auchangedbuf = N_("E812: Autocommands changed buffer or buffer name");
 
@@ -222,10 +226,18 @@ readfile(
     int		using_b_fname;
     static char *msg_is_a_directory = N_("is a directory");
     int         eof;
+    char_u	*batch_lines[READ_BATCH_LINES];	// lines not appended yet
+    colnr_T	batch_lens[READ_BATCH_LINES];
+    int		batch_count = 0;
 
     au_did_filetype = FALSE; // reset before triggering any autocommands
 
     curbuf->b_no_eol_lnum = 0;	// in case it was set by the previous read
+#if defined(FEAT_SYN_HL) && defined(FEAT_PERSISTENT_UNDO)
+    // The text is replaced, the hash is set again when the undo file is read.
+    if (newfile)
+	curbuf->b_syn_cache_hash_ok = FALSE;
+#endif
 
     /*
      * If there is no file name yet, use the one for the read file.
@@ -574,6 +586,16 @@ readfile(
 	return FAIL;
     }
 
+#if defined(HAVE_POSIX_FADVISE) && defined(POSIX_FADV_SEQUENTIAL)
+    /*
+     * The file is read once from start to end in large blocks.  Tell the
+     * kernel, so that it can read ahead more aggressively.  Makes a
+     * difference for huge files on slow storage.
+     */
+    if (!read_stdin && !read_buffer && !read_fifo)
+	(void)posix_fadvise(fd, (off_t)0, (off_t)0, POSIX_FADV_SEQUENTIAL);
+#endif
+
     /*
      * Only set the 'ro' flag for readonly files the first time they are
      * loaded.	Help files always get readonly mode
@@ -2164,16 +2186,20 @@ rewind_retry:
 		    {
 			*ptr = NUL;	    // end of line
 			len = (colnr_T) (ptr - line_start + 1);
-			if (ml_append(lnum, line_start, len, newfile) == FAIL)
-			{
-			    error = TRUE;
-			    break;
-			}
+			batch_lines[batch_count] = line_start;
+			batch_lens[batch_count++] = len;
 #ifdef FEAT_PERSISTENT_UNDO
 			if (read_undo_file)
 			    sha256_update(&sha_ctx, line_start, len);
 #endif
 			++lnum;
+			if (batch_count == READ_BATCH_LINES
+				&& readfile_append(lnum, batch_lines,
+				     batch_lens, &batch_count, newfile) == FAIL)
+			{
+			    error = TRUE;
+			    break;
+			}
 			if (--read_count == 0)
 			{
 			    error = TRUE;	// break loop
@@ -2189,74 +2215,94 @@ rewind_retry:
 	}
 	else
 	{
-	    --ptr;
-	    while (++ptr, --size >= 0)
+	    char_u	*eol;
+
+	    /*
+	     * Use memchr() to find the end of each line, the C library
+	     * usually checks many bytes at a time.  NULs are rare, only look
+	     * for them inside the line that was found.
+	     */
+	    while (size > 0)
 	    {
-		if ((c = *ptr) != NUL && c != NL)  // catch most common case
-		    continue;
-		if (c == NUL)
-		    *ptr = NL;	// NULs are replaced by newlines!
-		else
+		eol = memchr(ptr, NL, (size_t)size);
+		if (eol == NULL)
+		    eol = ptr + size;
+		for (p = ptr; (p = memchr(p, NUL, (size_t)(eol - p))) != NULL; )
+		    *p++ = NL;	// NULs are replaced by newlines!
+		size -= (long)(eol - ptr) + 1;
+		ptr = eol;
+		if (size < 0)
+		    break;	// no end-of-line in the rest of the buffer
+
+		if (skip_count == 0)
 		{
-		    if (skip_count == 0)
+		    *ptr = NUL;		// end of line
+		    len = (colnr_T)(ptr - line_start + 1);
+		    if (fileformat == EOL_DOS)
 		    {
-			*ptr = NUL;		// end of line
-			len = (colnr_T)(ptr - line_start + 1);
-			if (fileformat == EOL_DOS)
+			if (ptr > line_start && ptr[-1] == CAR)
 			{
-			    if (ptr > line_start && ptr[-1] == CAR)
-			    {
-				// remove CR before NL
-				ptr[-1] = NUL;
-				--len;
-			    }
-			    /*
-			     * Reading in Dos format, but no CR-LF found!
-			     * When 'fileformats' includes "unix", delete all
-			     * the lines read so far and start all over again.
-			     * Otherwise give an error message later.
-			     */
-			    else if (ff_error != EOL_DOS)
-			    {
-				if (   try_unix
-				    && !read_stdin
-				    && (read_buffer
-					|| vim_lseek(fd, (off_T)0L, SEEK_SET)
-									  == 0))
-				{
-				    fileformat = EOL_UNIX;
-				    if (set_options)
-					set_fileformat(EOL_UNIX, OPT_LOCAL);
-				    file_rewind = TRUE;
-				    keep_fileformat = TRUE;
-				    goto retry;
-				}
-				ff_error = EOL_DOS;
-			    }
+			    // remove CR before NL
+			    ptr[-1] = NUL;
+			    --len;
 			}
-			if (ml_append(lnum, line_start, len, newfile) == FAIL)
+			/*
+			 * Reading in Dos format, but no CR-LF found!
+			 * When 'fileformats' includes "unix", delete all
+			 * the lines read so far and start all over again.
+			 * Otherwise give an error message later.
+			 */
+			else if (ff_error != EOL_DOS)
 			{
-			    error = TRUE;
-			    break;
+			    if (   try_unix
+				&& !read_stdin
+				&& (read_buffer
+				    || vim_lseek(fd, (off_T)0L, SEEK_SET) == 0))
+			    {
+				// Lines not appended yet don't need to be
+				// deleted.
+				lnum -= batch_count;
+				batch_count = 0;
+				fileformat = EOL_UNIX;
+				if (set_options)
+				    set_fileformat(EOL_UNIX, OPT_LOCAL);
+				file_rewind = TRUE;
+				keep_fileformat = TRUE;
+				goto retry;
+			    }
+			    ff_error = EOL_DOS;
 			}
+		    }
+		    batch_lines[batch_count] = line_start;
+		    batch_lens[batch_count++] = len;
 #ifdef FEAT_PERSISTENT_UNDO
-			if (read_undo_file)
-			    sha256_update(&sha_ctx, line_start, len);
+		    if (read_undo_file)
+			sha256_update(&sha_ctx, line_start, len);
 #endif
-			++lnum;
-			if (--read_count == 0)
-			{
-			    error = TRUE;	    // break loop
-			    line_start = ptr;	// nothing left to write
-			    break;
-			}
+		    ++lnum;
+		    if (batch_count == READ_BATCH_LINES
+			    && readfile_append(lnum, batch_lines, batch_lens,
+						 &batch_count, newfile) == FAIL)
+		    {
+			error = TRUE;
+			break;
+		    }
+		    if (--read_count == 0)
+		    {
+			error = TRUE;	    // break loop
+			line_start = ptr;	// nothing left to write
+			break;
 		    }
-		    else
-			--skip_count;
-		    line_start = ptr + 1;
 		}
+		else
+		    --skip_count;
+		line_start = ++ptr;
 	    }
 	}
+	// Append the lines collected so far, "buffer" is going to be reused.
+	if (batch_count > 0 && readfile_append(lnum, batch_lines, batch_lens,
+						 &batch_count, newfile) == FAIL)
+	    error = TRUE;
 	linerest = (long)(ptr - line_start);
 	ui_breakcheck();
     }
@@ -2609,6 +2655,12 @@ failed:
 	sha256_finish(&sha_ctx, hash);
 	u_read_undo(NULL, hash, fname);
     }
+# ifdef FEAT_SYN_HL
+    // The syntax states may be found in the syntax cache file.
+    if (newfile && curbuf->b_p_udf && curbuf->b_ffname != NULL
+	    && !filtering && !read_fifo && !read_stdin && !read_buffer)
+	curbuf->b_syn_cache_read = TRUE;
+# endif
 #endif
 
     if (!read_stdin && !read_fifo && (!read_buffer || sfname != NULL))
@@ -2697,6 +2749,25 @@ readfile_linenr(
     return lnum;
 }
 
+/*
+ * Append the "*countp" lines collected in "lines" and "lens" to the current
+ * buffer, the last one becomes line "lnum".  Resets "*countp" to zero.
+ */
+    static int
+readfile_append(
+    linenr_T	lnum,
+    char_u	**lines,
+    colnr_T	*lens,
+    int		*countp,
+    int		newfile)
+{
+    int		count = *countp;
+
+    *countp = 0;
+    return ml_append_lines(lnum - count, lines, lens, count,
+						 newfile ? ML_APPEND_NEW : 0);
+}
+
 /*
  * Fill "*eap" to force the 'fileencoding', 'fileformat' and 'binary to be
  * equal to the buffer "buf".  Used for calling readfile().
@@ -4326,7 +4397,7 @@ buf_check_timestamp(
 
 	    // Any existing undo file is unusable, write it now.
 	    curbuf = buf;
-	    u_compute_hash(hash);
+	    u_compute_hash(curbuf, hash);
 	    u_write_undo(NULL, FALSE, buf, hash);
 	    curbuf = save_curbuf;
 	}
@@ -4375,6 +4446,10 @@ buf_reload(buf_T *buf, int orig_mode)
     {
 	old_cursor = curwin->w_cursor;
 	old_topline = curwin->w_topline;
+#if defined(FEAT_SYN_HL) && defined(FEAT_PERSISTENT_UNDO)
+	// Keep the syntax states, they can be used if the text didn't change.
+	syn_cache_write(curbuf);
+#endif
 
 	if (p_ur < 0 || curbuf->b_ml.ml_line_count <= p_ur)
 	{
@@ -4443,6 +4518,11 @@ buf_reload(buf_T *buf, int orig_mode)
 	    {
 		// Mark the buffer as unmodified and free undo info.
 		unchanged(buf, TRUE, TRUE);
+#if defined(FEAT_SYN_HL) && defined(FEAT_PERSISTENT_UNDO)
+		// Use the syntax cache instead of the states for the old text.
+		if (curbuf->b_syn_cache_read)
+		    syn_stack_free_all(&curbuf->b_s);
+#endif
 		if ((flags & READ_KEEP_UNDO) == 0)
 		{
 		    u_blockfree(buf);
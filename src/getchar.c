@@ -1559,7 +1559,7 @@ before_blocking(void)
     updatescript(0);
 #ifdef FEAT_EVAL
     if (may_garbage_collect)
-	garbage_collect(FALSE);
+	garbage_collect_idle();
 #endif
 }
 
@@ -1569,6 +1569,8 @@ before_blocking(void)
  *
  * All the changed memfiles are synced if c == 0 or when the number of typed
  * characters reaches 'updatecount' and 'updatecount' is non-zero.
+ * Flushing the swap files to disk can be slow, while typing it is postponed
+ * until waiting for a character.
  */
     static void
 updatescript(int c)
@@ -1579,7 +1581,7 @@ updatescript(int c)
 	putc(c, scriptout);
     if (c == 0 || (p_uc > 0 && ++count >= p_uc))
     {
-	ml_sync_all(c == 0, TRUE);
+	ml_sync_all(c == 0, TRUE, c == 0);
 	count = 0;
     }
 }
@@ -1243,6 +1243,10 @@ EXTERN reg_extmatch_T *re_extmatch_in INIT(= NULL); // Used by vim_regexec():
 EXTERN reg_extmatch_T *re_extmatch_out INIT(= NULL); // Set by vim_regexec()
 					    // to store \z\(...\) matches
 #endif
+EXTERN long	regcache_hits INIT(= 0);    // vim_regcomp() used a cached prog
+EXTERN long	regcache_misses INIT(= 0);  // vim_regcomp() compiled a prog
+EXTERN int	chartab_tick INIT(= 0);	    // incremented when the global
+					    // character table changes
 
 EXTERN int	did_outofmem_msg INIT(= FALSE);
 					    // set after out of memory msg
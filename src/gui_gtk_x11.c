@@ -2276,7 +2276,7 @@ sm_client_save_yourself(GnomeClient	    *client,
 					 &sm_client_check_changed_any,
 					 NULL);
     out_flush();
-    ml_sync_all(FALSE, FALSE); // preserve all swap files
+    ml_sync_all(FALSE, FALSE, TRUE); // preserve all swap files
 
     // The path is unique for each session save.  We do neither know nor care
     // which session script will actually be used later.  This decision is in
@@ -2491,7 +2491,7 @@ global_event_filter(GdkXEvent *xev,
 					    == GET_X_ATOM(save_yourself_atom))
     {
 	out_flush();
-	ml_sync_all(FALSE, FALSE); // preserve all swap files
+	ml_sync_all(FALSE, FALSE, TRUE); // preserve all swap files
 	/*
 	 * Set the window's WM_COMMAND property, to let the window manager
 	 * know we are done saving ourselves.  We don't want to be
@@ -2945,7 +2945,7 @@ gui_x11_wm_protocol_handler(
 						  wm_atoms[SAVE_YOURSELF_IDX])
     {
 	out_flush();
-	ml_sync_all(FALSE, FALSE);	// preserve all swap files
+	ml_sync_all(FALSE, FALSE, TRUE);	// preserve all swap files
 
 	// Set the window's WM_COMMAND property, to let the window manager
 	// know we are done saving ourselves.  We don't want to be restarted,
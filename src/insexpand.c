@@ -2752,7 +2752,7 @@ ins_compl_get_exp(pos_T *ini)
 		    // correctly.
 		    first_match_pos.lnum = ins_buf->b_ml.ml_line_count;
 		    first_match_pos.col =
-				 (colnr_T)STRLEN(ml_get(first_match_pos.lnum));
+				 ml_get_len(first_match_pos.lnum);
 		}
 		last_match_pos = first_match_pos;
 		type = 0;
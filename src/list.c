@@ -19,6 +19,8 @@ static char *e_listblobarg = N_("E899: Argument of %s must be a List or Blob");
 
 // List heads for garbage collection.
 static list_T		*first_list = NULL;	// list of all lists
+static list_T		*first_old_list = NULL;	// lists from here on existed
+						// at the last collection
 
 #define FOR_ALL_WATCHERS(l, lw) \
     for ((lw) = (l)->lv_watch; (lw) != NULL; (lw) = (lw)->lw_next)
@@ -239,12 +241,13 @@ list_free_contents(list_T *l)
  * Go through the list of lists and free items without the copyID.
  * But don't free a list that has a watcher (used in a for loop), these
  * are not referenced anywhere.
+ * Returns the number of lists that were emptied.
  */
     int
 list_free_nonref(int copyID)
 {
     list_T	*ll;
-    int		did_free = FALSE;
+    int		count = 0;
 
     for (ll = first_list; ll != NULL; ll = ll->lv_used_next)
 	if ((ll->lv_copyID & COPYID_MASK) != (copyID & COPYID_MASK)
@@ -254,15 +257,17 @@ list_free_nonref(int copyID)
 	    // into Lists and Dictionaries, they will be in the list of dicts
 	    // or list of lists.
 	    list_free_contents(ll);
-	    did_free = TRUE;
+	    ++count;
 	}
-    return did_free;
+    return count;
 }
 
     static void
 list_free_list(list_T  *l)
 {
     // Remove the list from the list of lists for garbage collection.
+    if (l == first_old_list)
+	first_old_list = l->lv_used_next;
     if (l->lv_used_prev == NULL)
 	first_list = l->lv_used_next;
     else
@@ -274,10 +279,15 @@ list_free_list(list_T  *l)
     vim_free(l);
 }
 
-    void
+/*
+ * Free the lists emptied by list_free_nonref().
+ * Returns the number of lists that are still in use.
+ */
+    int
 list_free_items(int copyID)
 {
     list_T	*ll, *ll_next;
+    int		count = 0;
 
     for (ll = first_list; ll != NULL; ll = ll_next)
     {
@@ -290,7 +300,71 @@ list_free_items(int copyID)
 	    // or list of lists.
 	    list_free_list(ll);
 	}
+	else
+	    ++count;
+    }
+    return count;
+}
+
+/*
+ * Add the lists created since the last garbage collection to "gap", as a
+ * typval, and mark them with "copyID".  New lists are inserted at the start
+ * of "first_list", these are the ones before "first_old_list".
+ * Returns FAIL when out of memory.
+ */
+    int
+list_add_young(garray_T *gap, int copyID)
+{
+    list_T	*ll;
+    typval_T	*tv;
+
+    for (ll = first_list; ll != first_old_list; ll = ll->lv_used_next)
+    {
+	if (ga_grow(gap, 1) == FAIL)
+	    return FAIL;
+	tv = ((typval_T *)gap->ga_data) + gap->ga_len++;
+	tv->v_type = VAR_LIST;
+	tv->vval.v_list = ll;
+	ll->lv_copyID = copyID;
+    }
+    return OK;
+}
+
+/*
+ * Called at the end of a garbage collection: all existing lists are old now.
+ */
+    void
+list_make_old(void)
+{
+    first_old_list = first_list;
+}
+
+/*
+ * Free the lists in "gap" that are still marked with "copyID", they are not
+ * referenced.  When "contents" is TRUE only free the items, like
+ * list_free_nonref(), otherwise free the lists themselves.
+ * Returns the number of lists.
+ */
+    int
+list_free_young(garray_T *gap, int copyID, int contents)
+{
+    typval_T	*tv;
+    int		i;
+    int		count = 0;
+
+    for (i = 0; i < gap->ga_len; ++i)
+    {
+	tv = ((typval_T *)gap->ga_data) + i;
+	if (tv->v_type == VAR_LIST && tv->vval.v_list->lv_copyID == copyID)
+	{
+	    if (contents)
+		list_free_contents(tv->vval.v_list);
+	    else
+		list_free_list(tv->vval.v_list);
+	    ++count;
+	}
     }
+    return count;
 }
 
     void
@@ -95,6 +95,10 @@
 #define MB_TOUPPER(c)	vim_toupper(c)
 #define MB_CASEFOLD(c)	(enc_utf8 ? utf_fold(c) : MB_TOLOWER(c))
 
+// b_chartab[] is an array of 32 bytes, each bit representing one of the
+// characters 0-255.
+#define GET_CHARTAB(buf, c) ((buf)->b_chartab[(unsigned)(c) >> 3] & (1 << ((c) & 0x7)))
+
 // Use our own isdigit() replacement, because on MS-Windows isdigit() returns
 // non-zero for superscript 1.  Also avoids that isdigit() crashes for numbers
 // below 0 and above 255.
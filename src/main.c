@@ -1599,7 +1599,7 @@ getout_preserve_modified(int exitval)
 # endif
 
     ml_close_notmod();		    // close all not-modified buffers
-    ml_sync_all(FALSE, FALSE);	    // preserve all swap files
+    ml_sync_all(FALSE, FALSE, TRUE);	    // preserve all swap files
     ml_close_all(FALSE);	    // close all memfiles, without deleting
     getout(exitval);		    // exit Vim properly
 }
@@ -1691,6 +1691,12 @@ getout(int exitval)
 		    break;
 	    }
 
+#if defined(FEAT_SYN_HL) && defined(FEAT_PERSISTENT_UNDO)
+	// Keep the syntax states for when the files are edited again.
+	FOR_ALL_BUFFERS(buf)
+	    syn_cache_write(buf);
+#endif
+
 	// deathtrap() blocks autocommands, but we do want to trigger
 	// VimLeavePre.
 	if (is_autocmd_blocked())
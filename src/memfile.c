@@ -69,7 +69,7 @@ static long_u	total_mem_used = 0;	// total memory used for memfiles
 static void mf_ins_hash(memfile_T *, bhdr_T *);
 static void mf_rem_hash(memfile_T *, bhdr_T *);
 static bhdr_T *mf_find_hash(memfile_T *, blocknr_T);
-static void mf_ins_used(memfile_T *, bhdr_T *);
+static void mf_ins_used(memfile_T *, bhdr_T *, int);
 static void mf_rem_used(memfile_T *, bhdr_T *);
 static bhdr_T *mf_release(memfile_T *, int);
 static bhdr_T *mf_alloc_bhdr(memfile_T *, int);
@@ -151,8 +151,14 @@ mf_open(char_u *fname, int flags)
     mfp->mf_free_first = NULL;		// free list is empty
     mfp->mf_used_first = NULL;		// used list is empty
     mfp->mf_used_last = NULL;
+    mfp->mf_cold_first = NULL;
     mfp->mf_dirty = FALSE;
+    mfp->mf_need_flush = FALSE;
     mfp->mf_used_count = 0;
+    mfp->mf_hot_count = 0;
+    mfp->mf_hits = 0;
+    mfp->mf_misses = 0;
+    mfp->mf_evictions = 0;
     mf_hash_init(&mfp->mf_hash);
     mf_hash_init(&mfp->mf_trans);
     mfp->mf_page_size = MEMFILE_PAGE_SIZE;
@@ -389,7 +395,7 @@ mf_new(memfile_T *mfp, int negative, int page_count)
     hp->bh_flags = BH_LOCKED | BH_DIRTY;	// new block is always dirty
     mfp->mf_dirty = TRUE;
     hp->bh_page_count = page_count;
-    mf_ins_used(mfp, hp);
+    mf_ins_used(mfp, hp, FALSE);
     mf_ins_hash(mfp, hp);
 
     /*
@@ -443,15 +449,18 @@ mf_get(memfile_T *mfp, blocknr_T nr, int page_count)
 	    mf_free_bhdr(hp);
 	    return NULL;
 	}
+	++mfp->mf_misses;
+	mf_ins_used(mfp, hp, FALSE);	// put in front of cold part
     }
     else
     {
+	++mfp->mf_hits;
 	mf_rem_used(mfp, hp);	// remove from list, insert in front below
 	mf_rem_hash(mfp, hp);
+	mf_ins_used(mfp, hp, TRUE);	// put in front of used list
     }
 
     hp->bh_flags |= BH_LOCKED;
-    mf_ins_used(mfp, hp);	// put in front of used list
     mf_ins_hash(mfp, hp);	// put in front of hash list
 
     return hp;
@@ -513,9 +522,10 @@ mf_free(memfile_T *mfp, bhdr_T *hp)
  *  MFS_ALL	If not given, blocks with negative numbers are not synced,
  *		even when they are dirty!
  *  MFS_STOP	Stop syncing when a character becomes available, but sync at
- *		least one block.
+ *		least one block.  Then the flush is also skipped.
  *  MFS_FLUSH	Make sure buffers are flushed to disk, so they will survive a
- *		system crash.
+ *		system crash.  Only done when blocks were written since the
+ *		last flush.
  *  MFS_ZERO	Only write block 0.
  *
  * Return FAIL for failure, OK otherwise
@@ -526,6 +536,7 @@ mf_sync(memfile_T *mfp, int flags)
     int		status;
     bhdr_T	*hp;
     int		got_int_save = got_int;
+    int		char_avail = FALSE;
 
     if (mfp->mf_fd < 0)	    // there is no file, nothing to do
     {
@@ -562,7 +573,10 @@ mf_sync(memfile_T *mfp, int flags)
 	    {
 		// Stop when char available now.
 		if (ui_char_avail())
+		{
+		    char_avail = TRUE;
 		    break;
+		}
 	    }
 	    else
 		ui_breakcheck();
@@ -577,8 +591,12 @@ mf_sync(memfile_T *mfp, int flags)
     if (hp == NULL || status == FAIL)
 	mfp->mf_dirty = FALSE;
 
-    if ((flags & MFS_FLUSH) && *p_sws != NUL)
+    // Flushing may take a long time, e.g. on a network drive.  When a
+    // character was typed do it later, the user doesn't want to wait.
+    if ((flags & MFS_FLUSH) && *p_sws != NUL && mfp->mf_need_flush
+								&& !char_avail)
     {
+	mfp->mf_need_flush = FALSE;
 #if defined(UNIX)
 # ifdef HAVE_FSYNC
 	/*
@@ -705,20 +723,57 @@ mf_find_hash(memfile_T *mfp, blocknr_T nr)
 }
 
 /*
- * insert block *hp in front of used list of memfile *mfp
+ * Insert block *hp in the used list of memfile *mfp.
+ * When "hot" is TRUE in front of the list, otherwise in front of the cold
+ * part of the list.
  */
     static void
-mf_ins_used(memfile_T *mfp, bhdr_T *hp)
+mf_ins_used(memfile_T *mfp, bhdr_T *hp, int hot)
 {
-    hp->bh_next = mfp->mf_used_first;
-    mfp->mf_used_first = hp;
-    hp->bh_prev = NULL;
-    if (hp->bh_next == NULL)	    // list was empty, adjust last pointer
+    bhdr_T	*next;
+
+    if (hot)
+    {
+	next = mfp->mf_used_first;
+	hp->bh_flags |= BH_HOT;
+	mfp->mf_hot_count += hp->bh_page_count;
+    }
+    else
+    {
+	next = mfp->mf_cold_first;
+	mfp->mf_cold_first = hp;
+	hp->bh_flags &= ~BH_HOT;
+    }
+
+    hp->bh_next = next;
+    if (next == NULL)		    // insert at the end of the list
+    {
+	hp->bh_prev = mfp->mf_used_last;
 	mfp->mf_used_last = hp;
+    }
+    else
+    {
+	hp->bh_prev = next->bh_prev;
+	next->bh_prev = hp;
+    }
+    if (hp->bh_prev == NULL)	    // insert at the start of the list
+	mfp->mf_used_first = hp;
     else
-	hp->bh_next->bh_prev = hp;
+	hp->bh_prev->bh_next = hp;
     mfp->mf_used_count += hp->bh_page_count;
     total_mem_used += hp->bh_page_count * mfp->mf_page_size;
+
+    // The hot part may use up to three quarters of the maximum, move the
+    // least recently used hot blocks to the cold part when it gets bigger.
+    while (mfp->mf_hot_count > mfp->mf_used_count_max
+					      - mfp->mf_used_count_max / 4)
+    {
+	hp = mfp->mf_cold_first == NULL ? mfp->mf_used_last
+						 : mfp->mf_cold_first->bh_prev;
+	hp->bh_flags &= ~BH_HOT;
+	mfp->mf_hot_count -= hp->bh_page_count;
+	mfp->mf_cold_first = hp;
+    }
 }
 
 /*
@@ -727,6 +782,10 @@ mf_ins_used(memfile_T *mfp, bhdr_T *hp)
     static void
 mf_rem_used(memfile_T *mfp, bhdr_T *hp)
 {
+    if (hp == mfp->mf_cold_first)
+	mfp->mf_cold_first = hp->bh_next;
+    if (hp->bh_flags & BH_HOT)
+	mfp->mf_hot_count -= hp->bh_page_count;
     if (hp->bh_next == NULL)	    // last block in used list
 	mfp->mf_used_last = hp->bh_prev;
     else
@@ -741,7 +800,8 @@ mf_rem_used(memfile_T *mfp, bhdr_T *hp)
 
 /*
  * Release the least recently used block from the used list if the number
- * of used memory blocks gets to big.
+ * of used memory blocks gets to big.  Blocks in the cold part of the list
+ * go first.
  *
  * Return the block header to the caller, including the memory block, so
  * it can be re-used. Make sure the page_count is right.
@@ -768,7 +828,10 @@ mf_release(memfile_T *mfp, int page_count)
 
     /*
      * Try to create a swap file if the amount of memory used is getting too
-     * high.
+     * high.  A buffer that can't be changed does not need a swap file for
+     * recovery, only create one when this buffer is using too much memory,
+     * not when all buffers together are.  Avoids a swap file for each of
+     * many read-only buffers.
      */
     if (mfp->mf_fd < 0 && need_release && p_uc)
     {
@@ -776,7 +839,9 @@ mf_release(memfile_T *mfp, int page_count)
 	FOR_ALL_BUFFERS(buf)
 	    if (buf->b_ml.ml_mfp == mfp)
 		break;
-	if (buf != NULL && buf->b_may_swap)
+	if (buf != NULL && buf->b_may_swap
+		&& (mfp->mf_used_count >= mfp->mf_used_count_max
+						   || !ml_readonly_buf(buf)))
 	    ml_open_file(buf);
     }
 
@@ -806,6 +871,7 @@ mf_release(memfile_T *mfp, int page_count)
 
     mf_rem_used(mfp, hp);
     mf_rem_hash(mfp, hp);
+    ++mfp->mf_evictions;
 
     /*
      * If a bhdr_T is returned, make sure that the page_count of bh_data is
@@ -1053,6 +1119,7 @@ mf_write(memfile_T *mfp, bhdr_T *hp)
 	}
 
 	did_swapwrite_msg = FALSE;
+	mfp->mf_need_flush = TRUE;
 	if (hp2 != NULL)		    // written a non-dummy block
 	    hp2->bh_flags &= ~BH_DIRTY;
 					    // appended to the file
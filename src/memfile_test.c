@@ -135,9 +135,78 @@ test_mf_hash(void)
     mf_hash_free_all(&ht);
 }
 
+/*
+ * Test the hot and cold parts of the used list.
+ */
+    static void
+test_mf_used(void)
+{
+    memfile_T	*mfp;
+    bhdr_T	*hp[8];
+    int		i;
+
+    mfp = mf_open(NULL, 0);
+    assert(mfp != NULL);
+    mfp->mf_used_count_max = 8;
+
+    // new blocks go in front of the cold part
+    for (i = 0; i < 8; i++)
+    {
+	hp[i] = mf_new(mfp, TRUE, 1);
+	assert(hp[i] != NULL);
+	mf_put(mfp, hp[i], FALSE, FALSE);
+    }
+    assert(mfp->mf_used_first == hp[7]);
+    assert(mfp->mf_cold_first == hp[7]);
+    assert(mfp->mf_used_last == hp[0]);
+    assert(mfp->mf_used_count == 8);
+    assert(mfp->mf_hot_count == 0);
+
+    // a block that is used again moves to the hot part
+    assert(mf_get(mfp, hp[2]->bh_bnum, 1) == hp[2]);
+    mf_put(mfp, hp[2], FALSE, FALSE);
+    assert(mfp->mf_used_first == hp[2]);
+    assert(mfp->mf_cold_first == hp[7]);
+    assert(mfp->mf_used_last == hp[0]);
+    assert(mfp->mf_hot_count == 1);
+    assert(mfp->mf_hits == 1);
+    assert(mfp->mf_misses == 0);
+
+    // the hot part uses at most three quarters, the least recently used
+    // hot blocks move to the cold part
+    for (i = 0; i < 8; i++)
+    {
+	assert(mf_get(mfp, hp[i]->bh_bnum, 1) == hp[i]);
+	mf_put(mfp, hp[i], FALSE, FALSE);
+    }
+    assert(mfp->mf_hot_count == 6);
+    assert(mfp->mf_used_count == 8);
+    assert(mfp->mf_used_first == hp[7]);
+    assert(mfp->mf_cold_first == hp[1]);
+    assert(mfp->mf_cold_first->bh_prev == hp[2]);
+    assert(mfp->mf_used_last == hp[0]);
+    assert(mfp->mf_hits == 9);
+    for (i = 0; i < 8; i++)
+	assert(((hp[i]->bh_flags & BH_HOT) != 0) == (i >= 2));
+
+    // removing blocks keeps the parts consistent
+    mf_free(mfp, hp[1]);
+    assert(mfp->mf_cold_first == hp[0]);
+    mf_free(mfp, hp[0]);
+    assert(mfp->mf_cold_first == NULL);
+    assert(mfp->mf_used_last == hp[2]);
+    mf_free(mfp, hp[7]);
+    assert(mfp->mf_used_first == hp[6]);
+    assert(mfp->mf_hot_count == 5);
+    assert(mfp->mf_used_count == 5);
+
+    mf_close(mfp, FALSE);
+}
+
     int
 main(void)
 {
     test_mf_hash();
+    test_mf_used();
     return 0;
 }
@@ -294,6 +294,9 @@ ml_open(buf_T *buf)
     buf->b_ml.ml_line_lnum = 0;	// no cached line
 #ifdef FEAT_BYTEOFF
     buf->b_ml.ml_chunksize = NULL;
+    buf->b_ml.ml_chunktree = NULL;
+    buf->b_ml.ml_chunktree_size = 0;
+    buf->b_ml.ml_chunktree_valid = FALSE;
 #endif
 
     if (cmdmod.cmod_flags & CMOD_NOSWAPFILE)
@@ -836,6 +839,16 @@ ml_open_file(buf_T *buf)
     buf->b_may_swap = FALSE;
 }
 
+/*
+ * Return TRUE if "buf" is 'readonly' or 'nomodifiable' and was not changed.
+ * Such a buffer doesn't need a swap file for recovery.
+ */
+    int
+ml_readonly_buf(buf_T *buf)
+{
+    return (buf->b_p_ro || !buf->b_p_ma) && !bufIsChanged(buf);
+}
+
 /*
  * If still need to create a swap file, and starting to edit a not-readonly
  * file, or reading into an existing buffer, create a swap file now.
@@ -846,7 +859,7 @@ check_need_swap(
 {
     int old_msg_silent = msg_silent; // might be reset by an E325 message
 
-    if (curbuf->b_may_swap && (!curbuf->b_p_ro || !newfile))
+    if (curbuf->b_may_swap && (!ml_readonly_buf(curbuf) || !newfile))
 	ml_open_file(curbuf);
     msg_silent = old_msg_silent;
 }
@@ -866,6 +879,9 @@ ml_close(buf_T *buf, int del_file)
     vim_free(buf->b_ml.ml_stack);
 #ifdef FEAT_BYTEOFF
     VIM_CLEAR(buf->b_ml.ml_chunksize);
+    VIM_CLEAR(buf->b_ml.ml_chunktree);
+    buf->b_ml.ml_chunktree_size = 0;
+    buf->b_ml.ml_chunktree_valid = FALSE;
 #endif
     buf->b_ml.ml_mfp = NULL;
 
@@ -2413,9 +2429,11 @@ end:
  * If 'check_file' is TRUE, check if original file exists and was not changed.
  * If 'check_char' is TRUE, stop syncing when character becomes available, but
  * always sync at least one block.
+ * If 'do_fsync' is TRUE make sure the swap file is flushed to disk, otherwise
+ * this is postponed until the next call with 'do_fsync' TRUE.
  */
     void
-ml_sync_all(int check_file, int check_char)
+ml_sync_all(int check_file, int check_char, int do_fsync)
 {
     buf_T		*buf;
     stat_T		st;
@@ -2446,10 +2464,11 @@ ml_sync_all(int check_file, int check_char)
 		need_check_timestamps = TRUE;	// give message later
 	    }
 	}
-	if (buf->b_ml.ml_mfp->mf_dirty)
+	if (buf->b_ml.ml_mfp->mf_dirty
+		|| (do_fsync && buf->b_ml.ml_mfp->mf_need_flush))
 	{
 	    (void)mf_sync(buf->b_ml.ml_mfp, (check_char ? MFS_STOP : 0)
-					| (bufIsChanged(buf) ? MFS_FLUSH : 0));
+			| (do_fsync && bufIsChanged(buf) ? MFS_FLUSH : 0));
 	    if (check_char && ui_char_avail())	// character available now
 		break;
 	}
@@ -2584,6 +2603,60 @@ ml_get_cursor(void)
 							curwin->w_cursor.col);
 }
 
+/*
+ * Return length (excluding the NUL) of the given line.
+ */
+    colnr_T
+ml_get_len(linenr_T lnum)
+{
+    return ml_get_buf_len(curbuf, lnum);
+}
+
+/*
+ * Return length (excluding the NUL) of the cursor line.
+ */
+    colnr_T
+ml_get_curline_len(void)
+{
+    return ml_get_buf_len(curbuf, curwin->w_cursor.lnum);
+}
+
+/*
+ * Return length (excluding the NUL) of the text after the cursor position.
+ */
+    colnr_T
+ml_get_cursor_len(void)
+{
+    return ml_get_buf_len(curbuf, curwin->w_cursor.lnum)
+							 - curwin->w_cursor.col;
+}
+
+/*
+ * Return length (excluding the NUL) of line "lnum" in buffer "buf".
+ * Mostly this uses the length that is known from the data block, thus avoids
+ * a STRLEN() on long lines.
+ */
+    colnr_T
+ml_get_buf_len(buf_T *buf, linenr_T lnum)
+{
+    char_u	*line = ml_get_buf(buf, lnum, FALSE);
+
+    if (*line == NUL)
+	return 0;
+    if (buf->b_ml.ml_line_textlen > 0)
+	return buf->b_ml.ml_line_textlen - 1;
+
+    // The length is not known, e.g. because of text properties, or the line
+    // was changed in place.  Only remember it when the line can't have been
+    // changed since it was read from the block.
+    if ((buf->b_ml.ml_flags & (ML_LINE_DIRTY | ML_LOCKED_DIRTY)) == 0)
+    {
+	buf->b_ml.ml_line_textlen = (colnr_T)STRLEN(line) + 1;
+	return buf->b_ml.ml_line_textlen - 1;
+    }
+    return (colnr_T)STRLEN(line);
+}
+
 /*
  * Return a pointer to a line in a specific buffer
  *
@@ -2613,6 +2686,7 @@ ml_get_buf(
 errorret:
 	STRCPY(IObuff, "???");
 	buf->b_ml.ml_line_len = 4;
+	buf->b_ml.ml_line_textlen = buf->b_ml.ml_line_len;
 	return IObuff;
     }
     if (lnum <= 0)			// pretend line 0 is line 1
@@ -2621,6 +2695,7 @@ errorret:
     if (buf->b_ml.ml_mfp == NULL)	// there are no lines
     {
 	buf->b_ml.ml_line_len = 1;
+	buf->b_ml.ml_line_textlen = buf->b_ml.ml_line_len;
 	return (char_u *)"";
     }
 
@@ -2673,11 +2748,22 @@ errorret:
 
 	buf->b_ml.ml_line_ptr = (char_u *)dp + start;
 	buf->b_ml.ml_line_len = len;
+#ifdef FEAT_PROP_POPUP
+	// With text properties the text length is computed when needed.
+	if (buf->b_has_textprop)
+	    buf->b_ml.ml_line_textlen = 0;
+	else
+#endif
+	    buf->b_ml.ml_line_textlen = len;
 	buf->b_ml.ml_line_lnum = lnum;
 	buf->b_ml.ml_flags &= ~ML_LINE_DIRTY;
     }
     if (will_change)
+    {
 	buf->b_ml.ml_flags |= (ML_LOCKED_DIRTY | ML_LOCKED_POS);
+	// the text may be changed in place, the length is not known then
+	buf->b_ml.ml_line_textlen = 0;
+    }
 
     return buf->b_ml.ml_line_ptr;
 }
@@ -3363,6 +3449,47 @@ ml_append_buf(
 }
 #endif
 
+/*
+ * Append "count" lines after lnum in the current buffer.  "lines[i]" is the
+ * text of a line and "lens[i]" its length including the NUL, or 0.
+ * Does the same as calling ml_append() for every line, but a pending change
+ * is flushed and listeners are checked only once.  Data blocks are filled one
+ * after another, the block being appended to stays locked.
+ *
+ * return FAIL for failure, OK otherwise
+ */
+    int
+ml_append_lines(
+    linenr_T	lnum,		// append after this line (can be 0)
+    char_u	**lines,	// text of the new lines
+    colnr_T	*lens,		// length of new lines, including NUL, or 0
+    int		count,		// number of lines in "lines"
+    int		flags)		// ML_APPEND_ values
+{
+    int		i;
+
+    if (count <= 0)
+	return OK;
+    if (curbuf->b_ml.ml_mfp == NULL && open_buffer(FALSE, NULL, 0) == FAIL)
+	return FAIL;
+    if (lnum > curbuf->b_ml.ml_line_count)
+	return FAIL;  // lnum out of range
+
+    if (curbuf->b_ml.ml_line_lnum != 0)
+	ml_flush_line(curbuf);
+#ifdef FEAT_EVAL
+    may_invoke_listeners(curbuf, lnum + 1, lnum + 1, count);
+    if (curbuf->b_ml.ml_line_lnum != 0)
+	ml_flush_line(curbuf);
+#endif
+
+    for (i = 0; i < count; ++i)
+	if (ml_append_int(curbuf, lnum + i, lines[i],
+				     lens == NULL ? 0 : lens[i], flags) == FAIL)
+	    return FAIL;
+    return OK;
+}
+
 /*
  * Replace line "lnum", with buffering, in current buffer.
  *
@@ -3428,7 +3555,7 @@ ml_replace_len(
 #ifdef FEAT_NETBEANS_INTG
     if (netbeans_active())
     {
-	netbeans_removed(curbuf, lnum, 0, (long)STRLEN(ml_get(lnum)));
+	netbeans_removed(curbuf, lnum, 0, (long)ml_get_len(lnum));
 	netbeans_inserted(curbuf, lnum, 0, line, (int)STRLEN(line));
     }
 #endif
@@ -3475,6 +3602,7 @@ ml_replace_len(
 
     curbuf->b_ml.ml_line_ptr = line;
     curbuf->b_ml.ml_line_len = len;
+    curbuf->b_ml.ml_line_textlen = !has_props ? len_arg + 1 : 0;
     curbuf->b_ml.ml_line_lnum = lnum;
     curbuf->b_ml.ml_flags = (curbuf->b_ml.ml_flags | ML_LINE_DIRTY) & ~ML_EMPTY;
 
@@ -5440,8 +5568,124 @@ ml_crypt_prepare(memfile_T *mfp, off_T offset, int reading)
 
 #if defined(FEAT_BYTEOFF) || defined(PROTO)
 
-#define MLCS_MAXL 800	// max no of lines in chunk
-#define MLCS_MINL 400   // should be half of MLCS_MAXL
+#define MLCS_MAXL 200	// max no of lines in chunk
+#define MLCS_MINL 100   // should be half of MLCS_MAXL
+
+/*
+ * The chunks are also kept in a Fenwick tree (binary indexed tree), so that
+ * the chunk for a line number or byte offset can be found in logarithmic
+ * time, instead of going over all the chunks.  Entry "i" of ml_chunktree
+ * (one based) holds the sum of the chunks "i - (i & -i)" to "i - 1".
+ * Adding or removing a line only updates the entries above the chunk.  When
+ * chunks are split or joined the tree is marked invalid and it is rebuilt
+ * when it is used next.
+ */
+
+/*
+ * Rebuild ml_chunktree from ml_chunksize.
+ * Return FAIL when out of memory.
+ */
+    static int
+ml_chunktree_build(buf_T *buf)
+{
+    memline_T	*ml = &buf->b_ml;
+    chunksize_T	*tree;
+    int		n = ml->ml_usedchunks;
+    int		i;
+    int		parent;
+
+    if (ml->ml_chunktree_size < n + 1)
+    {
+	vim_free(ml->ml_chunktree);
+	ml->ml_chunktree_size = 0;
+	ml->ml_chunktree = ALLOC_MULT(chunksize_T, ml->ml_numchunks + 1);
+	if (ml->ml_chunktree == NULL)
+	    return FAIL;
+	ml->ml_chunktree_size = ml->ml_numchunks + 1;
+    }
+
+    // Every entry is added to its parent, which comes later.
+    tree = ml->ml_chunktree;
+    for (i = 1; i <= n; ++i)
+	tree[i] = ml->ml_chunksize[i - 1];
+    for (i = 1; i <= n; ++i)
+    {
+	parent = i + (i & -i);
+	if (parent <= n)
+	{
+	    tree[parent].mlcs_numlines += tree[i].mlcs_numlines;
+	    tree[parent].mlcs_totalsize += tree[i].mlcs_totalsize;
+	}
+    }
+    ml->ml_chunktree_valid = TRUE;
+    return OK;
+}
+
+/*
+ * Add "lines" and "size" to chunk "idx" in ml_chunktree, if it is valid.
+ */
+    static void
+ml_chunktree_update(buf_T *buf, int idx, int lines, long size)
+{
+    chunksize_T	*tree = buf->b_ml.ml_chunktree;
+    int		i;
+
+    if (!buf->b_ml.ml_chunktree_valid)
+	return;
+    for (i = idx + 1; i <= buf->b_ml.ml_usedchunks; i += i & -i)
+    {
+	tree[i].mlcs_numlines += lines;
+	tree[i].mlcs_totalsize += size;
+    }
+}
+
+/*
+ * Find the chunk that contains line "lnum" (if not zero) or byte "offset" (if
+ * not zero), but not beyond the last chunk.  When "ffdos" is TRUE a CR is
+ * counted for every line before "offset".
+ * Returns the chunk index and puts the first line of the chunk in "*linep"
+ * and the number of bytes before it, without CRs, in "*sizep".
+ * Returns -1 when out of memory.
+ */
+    static int
+ml_chunktree_find(
+    buf_T	*buf,
+    linenr_T	lnum,
+    long	offset,
+    int		ffdos,
+    linenr_T	*linep,
+    long	*sizep)
+{
+    int		last = buf->b_ml.ml_usedchunks - 1;
+    int		idx = 0;
+    int		step;
+    linenr_T	lines = 0;
+    long	size = 0;
+    chunksize_T	*tp;
+
+    if (!buf->b_ml.ml_chunktree_valid && ml_chunktree_build(buf) == FAIL)
+	return -1;
+
+    for (step = 1; step * 2 <= last; step *= 2)
+	;
+    for ( ; step > 0; step /= 2)
+    {
+	if (idx + step > last)
+	    continue;
+	tp = buf->b_ml.ml_chunktree + idx + step;
+	if ((lnum != 0 && lnum >= lines + tp->mlcs_numlines + 1)
+		|| (offset != 0 && offset > size + tp->mlcs_totalsize
+				 + ffdos * (lines + tp->mlcs_numlines)))
+	{
+	    idx += step;
+	    lines += tp->mlcs_numlines;
+	    size += tp->mlcs_totalsize;
+	}
+    }
+    *linep = lines + 1;
+    *sizep = size;
+    return idx;
+}
 
 /*
  * Keep information for finding byte offset of a line, updtype may be one of:
@@ -5484,6 +5728,7 @@ ml_updatechunk(
 	buf->b_ml.ml_usedchunks = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_totalsize = 1;
+	buf->b_ml.ml_chunktree_valid = FALSE;
     }
 
     if (updtype == ML_CHNK_UPDLINE && buf->b_ml.ml_line_count == 1)
@@ -5494,6 +5739,7 @@ ml_updatechunk(
 	buf->b_ml.ml_usedchunks = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_totalsize = (long)buf->b_ml.ml_line_len;
+	buf->b_ml.ml_chunktree_valid = FALSE;
 	return;
     }
 
@@ -5504,11 +5750,17 @@ ml_updatechunk(
     if (buf != ml_upd_lastbuf || line != ml_upd_lastline + 1
 	    || updtype != ML_CHNK_ADDLINE)
     {
-	for (curline = 1, curix = 0;
-	     curix < buf->b_ml.ml_usedchunks - 1
-	     && line >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-	     curix++)
-	    curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
+	curix = ml_chunktree_find(buf, line, 0L, FALSE, &curline, &size);
+	if (curix < 0)
+	{
+	    // out of memory, go over the chunks
+	    for (curline = 1, curix = 0;
+		    curix < buf->b_ml.ml_usedchunks - 1
+		    && line >= curline
+				+ buf->b_ml.ml_chunksize[curix].mlcs_numlines;
+		    curix++)
+		curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
+	}
     }
     else if (curix < buf->b_ml.ml_usedchunks - 1
 	      && line >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines)
@@ -5522,6 +5774,8 @@ ml_updatechunk(
     if (updtype == ML_CHNK_DELLINE)
 	len = -len;
     curchnk->mlcs_totalsize += len;
+    ml_chunktree_update(buf, curix, updtype == ML_CHNK_ADDLINE ? 1
+				   : updtype == ML_CHNK_DELLINE ? -1 : 0, len);
     if (updtype == ML_CHNK_ADDLINE)
     {
 	curchnk->mlcs_numlines++;
@@ -5610,6 +5864,7 @@ ml_updatechunk(
 	    buf->b_ml.ml_chunksize[curix].mlcs_totalsize = size;
 	    buf->b_ml.ml_chunksize[curix + 1].mlcs_totalsize -= size;
 	    buf->b_ml.ml_usedchunks++;
+	    buf->b_ml.ml_chunktree_valid = FALSE;
 	    ml_upd_lastbuf = NULL;   // Force recalc of curix & curline
 	    return;
 	}
@@ -5623,6 +5878,7 @@ ml_updatechunk(
 	     */
 	    curchnk = buf->b_ml.ml_chunksize + curix + 1;
 	    buf->b_ml.ml_usedchunks++;
+	    buf->b_ml.ml_chunktree_valid = FALSE;
 	    if (line == buf->b_ml.ml_line_count)
 	    {
 		curchnk->mlcs_numlines = 0;
@@ -5668,6 +5924,7 @@ ml_updatechunk(
 	else if (curix == 0 && curchnk->mlcs_numlines <= 0)
 	{
 	    buf->b_ml.ml_usedchunks--;
+	    buf->b_ml.ml_chunktree_valid = FALSE;
 	    mch_memmove(buf->b_ml.ml_chunksize, buf->b_ml.ml_chunksize + 1,
 			buf->b_ml.ml_usedchunks * sizeof(chunksize_T));
 	    return;
@@ -5683,6 +5940,7 @@ ml_updatechunk(
 	curchnk[-1].mlcs_numlines += curchnk->mlcs_numlines;
 	curchnk[-1].mlcs_totalsize += curchnk->mlcs_totalsize;
 	buf->b_ml.ml_usedchunks--;
+	buf->b_ml.ml_chunktree_valid = FALSE;
 	if (curix < buf->b_ml.ml_usedchunks)
 	{
 	    mch_memmove(buf->b_ml.ml_chunksize + curix,
@@ -5739,8 +5997,15 @@ ml_find_line_or_offset(buf_T *buf, linenr_T lnum, long *offp)
      * Find the last chunk before the one containing our line. Last chunk is
      * special because it will never qualify
      */
-    curline = 1;
-    curix = size = 0;
+    curix = ml_chunktree_find(buf, lnum, offset, ffdos, &curline, &size);
+    if (curix < 0)
+    {
+	// out of memory, go over the chunks below
+	curline = 1;
+	curix = size = 0;
+    }
+    else if (offset && ffdos)
+	size += curline - 1;
     while (curix < buf->b_ml.ml_usedchunks - 1
 	    && ((lnum != 0
 	     && lnum >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines)
@@ -2190,7 +2190,7 @@ preserve_exit(void)
 	    OUT_STR("Vim: preserving files...\r\n");
 	    screen_start();	    // don't know where cursor is now
 	    out_flush();
-	    ml_sync_all(FALSE, FALSE);	// preserve all swap files
+	    ml_sync_all(FALSE, FALSE, TRUE);	// preserve all swap files
 	    break;
 	}
     }
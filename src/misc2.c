@@ -553,7 +553,7 @@ check_cursor_col_win(win_T *win)
     colnr_T oldcol = win->w_cursor.col;
     colnr_T oldcoladd = win->w_cursor.col + win->w_cursor.coladd;
 
-    len = (colnr_T)STRLEN(ml_get_buf(win->w_buffer, win->w_cursor.lnum, FALSE));
+    len = ml_get_buf_len(win->w_buffer, win->w_cursor.lnum);
     if (len == 0)
 	win->w_cursor.col = 0;
     else if (win->w_cursor.col >= len)
@@ -1909,7 +1909,9 @@ vim_strchr(char_u *string, int c)
 	}
 	return NULL;
     }
-    if (has_mbyte)
+    // In UTF-8 an ASCII byte is never part of a multi-byte character, the
+    // faster loop below can be used.
+    if (has_mbyte && !enc_utf8)
     {
 	while ((b = *p) != NUL)
 	{
@@ -957,8 +957,8 @@ nb_joinlines(linenr_T first, linenr_T other)
     int len_first, len_other;
     char_u *p;
 
-    len_first = (int)STRLEN(ml_get(first));
-    len_other = (int)STRLEN(ml_get(other));
+    len_first = ml_get_len(first);
+    len_other = ml_get_len(other);
     p = alloc(len_first + len_other + 1);
     if (p != NULL)
     {
@@ -3315,7 +3315,7 @@ get_buf_size(buf_T *bufp)
 	    eol_size = 1;
 	for (lnum = 1; lnum <= bufp->b_ml.ml_line_count; ++lnum)
 	{
-	    char_count += (long)STRLEN(ml_get_buf(bufp, lnum, FALSE))
+	    char_count += (long)ml_get_buf_len(bufp, lnum)
 								   + eol_size;
 	    // Check for a CTRL-C every 100000 characters
 	    if (char_count > last_check)
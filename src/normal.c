@@ -3434,7 +3434,7 @@ nv_colon(cmdarg_T *cap)
 	else if (cap->oap->op_type != OP_NOP
 		&& (cap->oap->start.lnum > curbuf->b_ml.ml_line_count
 		    || cap->oap->start.col >
-			       (colnr_T)STRLEN(ml_get(cap->oap->start.lnum))
+			       ml_get_len(cap->oap->start.lnum)
 		    || did_emsg
 		    ))
 	    // The start of the operator has become invalid by the Ex command.
@@ -6230,7 +6230,7 @@ nv_g_cmd(cmdarg_T *cap)
 	{
 	    curwin->w_cursor = curbuf->b_last_insert;
 	    check_cursor_lnum();
-	    i = (int)STRLEN(ml_get_curline());
+	    i = ml_get_curline_len();
 	    if (curwin->w_cursor.col > (colnr_T)i)
 	    {
 		if (virtual_active())
@@ -6864,7 +6864,7 @@ unadjust_for_sel(void)
 	else if (pp->lnum > 1)
 	{
 	    --pp->lnum;
-	    pp->col = (colnr_T)STRLEN(ml_get(pp->lnum));
+	    pp->col = ml_get_len(pp->lnum);
 	    return TRUE;
 	}
     }
@@ -7037,7 +7037,7 @@ set_cursor_for_append_to_line(void)
 	State = save_State;
     }
     else
-	curwin->w_cursor.col += (colnr_T)STRLEN(ml_get_cursor());
+	curwin->w_cursor.col += ml_get_cursor_len();
 }
 
 /*
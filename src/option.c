@@ -2739,7 +2739,7 @@ set_bool_option(
 		    if (crypt_get_method_nr(curbuf) == CRYPT_M_SOD)
 			continue;
 #endif
-		    u_compute_hash(hash);
+		    u_compute_hash(curbuf, hash);
 		    u_read_undo(NULL, hash, curbuf->b_fname);
 		}
 	    }
@@ -877,7 +877,7 @@ catch_sigpwr SIGDEFARG(sigarg)
      * down or when the batteries are almost empty.  Just preserve the swap
      * files and don't exit, that can't do any harm.
      */
-    ml_sync_all(FALSE, FALSE);
+    ml_sync_all(FALSE, FALSE, TRUE);
     SIGRETURN;
 }
 #endif
@@ -1600,7 +1600,7 @@ x_error_handler(Display *dpy, XErrorEvent *error_event)
     // In the GUI we cannot print a message and continue, because no X calls
     // are allowed here (causes my system to hang).  Silently continuing seems
     // like the best alternative.  Do preserve files, in case we crash.
-    ml_sync_all(FALSE, FALSE);
+    ml_sync_all(FALSE, FALSE, TRUE);
 
 #ifdef FEAT_GUI
     if (!gui.in_use)
@@ -7960,7 +7960,7 @@ xsmp_handle_save_yourself(
 
     // First up, preserve all files
     out_flush();
-    ml_sync_all(FALSE, FALSE);	// preserve all swap files
+    ml_sync_all(FALSE, FALSE, TRUE);	// preserve all swap files
 
     if (p_verbose > 0)
 	verb_msg(_("XSMP handling save-yourself request"));
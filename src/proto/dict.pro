@@ -8,7 +8,10 @@ void dict_free_contents(dict_T *d);
 void hashtab_free_contents(hashtab_T *ht);
 void dict_unref(dict_T *d);
 int dict_free_nonref(int copyID);
-void dict_free_items(int copyID);
+int dict_free_items(int copyID);
+int dict_add_young(garray_T *gap, int copyID);
+void dict_make_old(void);
+int dict_free_young(garray_T *gap, int copyID, int contents);
 dictitem_T *dictitem_alloc(char_u *key);
 void dictitem_remove(dict_T *dict, dictitem_T *item);
 void dictitem_free(dictitem_T *item);
@@ -17,6 +20,7 @@ int dict_wrong_func_name(dict_T *d, typval_T *tv, char_u *name);
 int dict_add(dict_T *d, dictitem_T *item);
 int dict_add_number(dict_T *d, char *key, varnumber_T nr);
 int dict_add_bool(dict_T *d, char *key, varnumber_T nr);
+int dict_add_float(dict_T *d, char *key, float_T nr);
 int dict_add_string(dict_T *d, char *key, char_u *str);
 int dict_add_string_len(dict_T *d, char *key, char_u *str, int len);
 int dict_add_list(dict_T *d, char *key, list_T *list);
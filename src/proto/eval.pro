@@ -48,6 +48,9 @@ char_u *partial_name(partial_T *pt);
 void partial_unref(partial_T *pt);
 int get_copyID(void);
 int garbage_collect(int testing);
+int garbage_collect_young(void);
+void garbage_collect_idle(void);
+void garbage_collect_info(dict_T *d);
 int set_ref_in_ht(hashtab_T *ht, int copyID, list_stack_T **list_stack);
 int set_ref_in_dict(dict_T *d, int copyID);
 int set_ref_in_list(list_T *ll, int copyID);
@@ -10,7 +10,10 @@ int rettv_list_alloc_id(typval_T *rettv, alloc_id_T id);
 void rettv_list_set(typval_T *rettv, list_T *l);
 void list_unref(list_T *l);
 int list_free_nonref(int copyID);
-void list_free_items(int copyID);
+int list_free_items(int copyID);
+int list_add_young(garray_T *gap, int copyID);
+void list_make_old(void);
+int list_free_young(garray_T *gap, int copyID, int contents);
 void list_free(list_T *l);
 listitem_T *listitem_alloc(void);
 void listitem_free(list_T *l, listitem_T *item);
@@ -11,6 +11,7 @@ int vim_regsub_multi(regmmatch_T *rmp, linenr_T lnum, char_u *source, char_u *de
 char_u *reg_submatch(int no);
 list_T *reg_submatch_list(int no);
 int vim_regcomp_had_eol(void);
+void ex_regexptime(exarg_T *eap);
 regprog_T *vim_regcomp(char_u *expr_arg, int re_flags);
 void vim_regfree(regprog_T *prog);
 void free_regexp_stuff(void);
@@ -19,4 +20,5 @@ int vim_regexec_prog(regprog_T **prog, int ignore_case, char_u *line, colnr_T co
 int vim_regexec(regmatch_T *rmp, char_u *line, colnr_T col);
 int vim_regexec_nl(regmatch_T *rmp, char_u *line, colnr_T col);
 long vim_regexec_multi(regmmatch_T *rmp, win_T *win, buf_T *buf, linenr_T lnum, colnr_T col, proftime_T *tm, int *timed_out);
+int vim_regexec_multi_lines(regmmatch_T *rmp, win_T *win, buf_T *buf, linenr_T lnum, linenr_T lnum_last, int maxcount, garray_T *gap, proftime_T *tm, int *timed_out);
 /* vim: set ft=c : */
@@ -1,6 +1,9 @@
 /* syntax.c */
 void syn_set_timeout(proftime_T *tm);
 void syntax_start(win_T *wp, linenr_T lnum);
+int syntax_idle_pending(void);
+void syntax_idle_parse(long msec);
+void syn_cache_write(buf_T *buf);
 void syn_stack_free_all(synblock_T *block);
 void syn_stack_apply_changes(buf_T *buf);
 void syntax_end_parsing(linenr_T lnum);
@@ -6,7 +6,8 @@ int u_inssub(linenr_T lnum);
 int u_savedel(linenr_T lnum, long nlines);
 int undo_allowed(void);
 int u_savecommon(linenr_T top, linenr_T bot, linenr_T newbot, int reload);
-void u_compute_hash(char_u *hash);
+void u_compute_hash(buf_T *buf, char_u *hash);
+char_u *u_get_syn_cache_name(char_u *buf_ffname, int reading);
 void u_write_undo(char_u *name, int forceit, buf_T *buf, char_u *hash);
 void u_read_undo(char_u *name, char_u *hash, char_u *orig_name);
 void u_undo(int count);
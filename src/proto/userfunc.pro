@@ -10,6 +10,7 @@ int get_func_tv(char_u *name, int len, typval_T *rettv, char_u **arg, evalarg_T
 char_u *fname_trans_sid(char_u *name, char_u *fname_buf, char_u **tofree, int *error);
 ufunc_T *find_func_even_dead(char_u *name, int is_global, cctx_T *cctx);
 ufunc_T *find_func(char_u *name, int is_global, cctx_T *cctx);
+int func_hashtab_changed(void);
 int func_is_global(ufunc_T *ufunc);
 int func_name_refcount(char_u *name);
 int copy_func(char_u *lambda, char_u *global, ectx_T *ectx);
@@ -6010,7 +6010,7 @@ vgr_match_buflines(
 		    break;
 		col = regmatch->endpos[0].col
 		    + (col == regmatch->endpos[0].col);
-		if (col > (colnr_T)STRLEN(ml_get_buf(buf, lnum, FALSE)))
+		if (col > ml_get_buf_len(buf, lnum))
 		    break;
 	    }
 	}
@@ -6181,6 +6181,173 @@ existing_swapfile(buf_T *buf)
     return FALSE;
 }
 
+// Events that may be triggered when loading a file in a dummy buffer.
+static event_T vgr_load_events[] = {
+    EVENT_BUFNEW, EVENT_BUFADD, EVENT_BUFREADPRE, EVENT_BUFREADPOST,
+    EVENT_BUFREADCMD, EVENT_FILEREADPRE, EVENT_FILEREADPOST,
+    EVENT_FILEREADCMD, EVENT_BUFENTER, EVENT_BUFLEAVE, EVENT_BUFWINENTER,
+    EVENT_BUFWINLEAVE, EVENT_BUFUNLOAD, EVENT_BUFDELETE, EVENT_BUFWIPEOUT,
+    EVENT_SWAPEXISTS, EVENT_ENCODINGCHANGED
+};
+
+// Files larger than this are always loaded in a dummy buffer.
+#define VGR_MAX_QUICK_SIZE	(64 * 1024 * 1024)
+
+/*
+ * Check whether file "fname" can contain a match for the :vimgrep pattern
+ * without loading it into a dummy buffer, which is slow: it creates a
+ * buffer, a memfile and possibly a swap file.
+ * This is only possible when the file would be loaded without changing its
+ * text: valid UTF-8 without a BOM, no NUL or CR characters, not encrypted, and
+ * no autocommands that might do something when it is loaded, other than
+ * filetype detection.  The pattern must only depend on the text of a single
+ * line.
+ * Returns FALSE when there certainly is no match, TRUE when there might be
+ * one or the file can't be checked this way.
+ */
+    static int
+vgr_file_may_match(char_u *fname, vgr_args_T *cmd_args)
+{
+    char_u	*p;
+    char_u	*buffer;
+    char_u	*end;
+    char_u	*line;
+    stat_T	st;
+    FILE	*fd;
+    size_t	size;
+    int		i;
+    int		may_match = TRUE;
+
+    // Lines are split at a NL, that is only done when 'fileformats' includes
+    // "unix" or "dos".
+    if (p_bin || (vim_strchr(p_ffs, 'x') == NULL
+					      && vim_strchr(p_ffs, 'd') == NULL))
+	return TRUE;
+
+    // The text must not be converted: the first encoding tried must be utf-8
+    // or, for a single-byte 'encoding', there is no conversion at all.
+    p = p_fencs;
+    if (STRNCMP(p, "ucs-bom", 7) == 0 && (p[7] == NUL || p[7] == ','))
+	p += p[7] == NUL ? 7 : 8;
+    if (enc_utf8)
+    {
+	if (STRNCMP(p, "utf-8", 5) == 0)
+	    p += 5;
+	else if (STRNCMP(p, "utf8", 4) == 0)
+	    p += 4;
+	else
+	    return TRUE;
+	if (*p != NUL && *p != ',')
+	    return TRUE;
+    }
+    else if (has_mbyte || *p != NUL || (*p_fencs == NUL && *p_fenc != NUL))
+	return TRUE;
+
+    // A pattern with "\%" may match a line number, mark, cursor position or
+    // the start or end of the file, which can't be checked here.  Also "%"
+    // after "\v".
+    if (!(cmd_args->flags & VGR_FUZZY)
+	    && (re_multiline(cmd_args->regmatch.regprog)
+		|| vim_strchr(cmd_args->spat, '%') != NULL))
+	return TRUE;
+
+    // Keyword characters are taken from the current buffer instead of the
+    // global option value used for a dummy buffer.
+    if (STRCMP(curbuf->b_p_isk, p_isk) != 0)
+	return TRUE;
+
+    // Filetype detection does not change the text, ignore it like the
+    // FileType event is ignored when loading the file.
+    for (i = 0; i < (int)ARRAY_LENGTH(vgr_load_events); ++i)
+	if (has_autocmd_skip_group(vgr_load_events[i], fname, NULL,
+						 (char_u *)"filetypedetect"))
+	    return TRUE;
+
+    if (mch_stat((char *)fname, &st) < 0 || !S_ISREG(st.st_mode)
+					    || st.st_size > VGR_MAX_QUICK_SIZE)
+	return TRUE;
+
+    fd = mch_fopen((char *)fname, READBIN);
+    if (fd == NULL)
+	return TRUE;
+    size = (size_t)st.st_size;
+    buffer = alloc(size + 1);
+    if (buffer == NULL || fread(buffer, 1, size, fd) != size)
+    {
+	fclose(fd);
+	vim_free(buffer);
+	return TRUE;
+    }
+    fclose(fd);
+    end = buffer + size;
+    *end = NUL;
+
+    // Text that is changed when loading the file.
+    if ((size >= 3 && buffer[0] == 0xef && buffer[1] == 0xbb
+							&& buffer[2] == 0xbf)
+	    || (size >= 2 && ((buffer[0] == 0xfe && buffer[1] == 0xff)
+			       || (buffer[0] == 0xff && buffer[1] == 0xfe)))
+#ifdef FEAT_CRYPT
+	    || (size >= 9 && STRNCMP(buffer, "VimCrypt~", 9) == 0)
+#endif
+	    || memchr(buffer, NUL, size) != NULL
+	    || memchr(buffer, CAR, size) != NULL)
+	goto theend;
+    for (p = buffer; enc_utf8 && p < end; ++p)
+	if (*p >= 0x80)
+	{
+	    int	l = utf_ptr2len_len(p, (int)(end - p));
+
+	    if (l == 1 || l > end - p)
+		goto theend;
+	    p += l - 1;
+	}
+
+    // The lines are checked for a match like vgr_match_buflines() does, only
+    // the first match in each line matters.
+    may_match = FALSE;
+    line = buffer;
+    while (!may_match && !got_int)
+    {
+	p = vim_strchr(line, NL);
+	if (p != NULL)
+	    *p = NUL;
+	if (!(cmd_args->flags & VGR_FUZZY))
+	{
+	    regmatch_T	regmatch;
+
+	    regmatch.regprog = cmd_args->regmatch.regprog;
+	    regmatch.rm_ic = cmd_args->regmatch.rmm_ic;
+	    may_match = vim_regexec(&regmatch, line, (colnr_T)0);
+	    // The engine may have been switched.
+	    cmd_args->regmatch.regprog = regmatch.regprog;
+	    if (regmatch.regprog == NULL)
+	    {
+		may_match = TRUE;
+		break;
+	    }
+	}
+	else
+	{
+	    int	    score;
+	    int_u   matches[MAX_FUZZY_MATCHES];
+
+	    may_match = fuzzy_match(line, cmd_args->spat, FALSE, &score,
+					  matches, ARRAY_LENGTH(matches)) > 0;
+	}
+	// A file ending in a NL does not have an empty line after it, but an
+	// empty file has one empty line.
+	if (p == NULL || p + 1 >= end)
+	    break;
+	line = p + 1;
+	line_breakcheck();
+    }
+
+theend:
+    vim_free(buffer);
+    return may_match;
+}
+
 /*
  * Search for a pattern in a list of files and populate the quickfix list with
  * the matches.
@@ -6232,6 +6399,10 @@ vgr_process_files(
 	buf = buflist_findname_exp(cmd_args->fnames[fi]);
 	if (buf == NULL || buf->b_ml.ml_mfp == NULL)
 	{
+	    // Skip loading the file when it can't have a match.
+	    if (!vgr_file_may_match(fname, cmd_args))
+		continue;
+
 	    // Remember that a buffer with this name already exists.
 	    duplicate_name = (buf != NULL);
 	    using_dummy = TRUE;
@@ -376,6 +376,7 @@ static int	coll_get_char(void);
 static int	prog_magic_wrong(void);
 static int	cstrncmp(char_u *s1, char_u *s2, int *n);
 static char_u	*cstrchr(char_u *, int);
+static char_u	*find_regmust(char_u *s, char_u *must, int *mlen);
 static int	re_mult_next(char *what);
 static int	reg_iswordc(int);
 #ifdef FEAT_EVAL
@@ -1199,6 +1200,22 @@ reg_getline(linenr_T lnum)
     return ml_get_buf(rex.reg_buf, rex.reg_firstlnum + lnum, FALSE);
 }
 
+/*
+ * Get length of line "lnum", which is relative to "reg_firstlnum".
+ */
+    static colnr_T
+reg_getline_len(linenr_T lnum)
+{
+    // when looking behind for a match/no-match lnum is negative.  But we
+    // can't go before line 1
+    if (rex.reg_firstlnum + lnum < 1)
+	return 0;
+    if (lnum > rex.reg_maxline)
+	// Must have matched the "\n" in the last line.
+	return 0;
+    return ml_get_buf_len(rex.reg_buf, rex.reg_firstlnum + lnum);
+}
+
 #ifdef FEAT_SYN_HL
 static char_u	*reg_startzp[NSUBEXP];	// Workspace to mark beginning
 static char_u	*reg_endzp[NSUBEXP];	//   and end of \z(...\) matches
@@ -1690,6 +1707,51 @@ cstrchr(char_u *s, int c)
     return NULL;
 }
 
+/*
+ * Find the "must appear" string "must" with length "*mlen" in "s".
+ * Returns a pointer to where it was found, NULL if it does not appear.
+ */
+    static char_u *
+find_regmust(char_u *s, char_u *must, int *mlen)
+{
+    int c;
+
+    // Without ignoring case or composing characters a plain byte search
+    // finds it, this is a lot faster than the loops below.
+    if (!rex.reg_ic && !rex.reg_icombine && enc_dbcs == 0)
+	return (char_u *)strstr((char *)s, (char *)must);
+
+    if (has_mbyte)
+	c = (*mb_ptr2char)(must);
+    else
+	c = *must;
+
+    // This is used very often, esp. for ":global".  Use three versions of
+    // the loop to avoid overhead of conditions.
+    if (!rex.reg_ic && !has_mbyte)
+	while ((s = vim_strbyte(s, c)) != NULL)
+	{
+	    if (cstrncmp(s, must, mlen) == 0)
+		break;		// Found it.
+	    ++s;
+	}
+    else if (!rex.reg_ic || (!enc_utf8 && mb_char2len(c) > 1))
+	while ((s = vim_strchr(s, c)) != NULL)
+	{
+	    if (cstrncmp(s, must, mlen) == 0)
+		break;		// Found it.
+	    MB_PTR_ADV(s);
+	}
+    else
+	while ((s = cstrchr(s, c)) != NULL)
+	{
+	    if (cstrncmp(s, must, mlen) == 0)
+		break;		// Found it.
+	    MB_PTR_ADV(s);
+	}
+    return s;
+}
+
 ////////////////////////////////////////////////////////////////
 //		      regsub stuff			      //
 ////////////////////////////////////////////////////////////////
@@ -2614,9 +2676,334 @@ static char_u regname[][30] = {
 			    };
 #endif
 
+/*
+ * Cache of compiled patterns, so that compiling the same pattern again, e.g.
+ * for "n" or for ":s" inside ":g", only needs a lookup.  The cache holds a
+ * reference to each prog, it is freed when the last user calls vim_regfree().
+ */
+#define REGCACHE_SIZE 32
+
+typedef struct
+{
+    char_u	*rc_pat;	// pattern given to vim_regcomp(), NULL if unused
+    hash_T	rc_hash;	// hash of rc_pat
+    int		rc_flags;	// "re_flags" given to vim_regcomp()
+    int		rc_state;	// options the prog depends on, regcache_state()
+    int		rc_had_eol;	// had_eol after compiling
+    long	rc_used;	// regcache_tick when last used
+    regprog_T	*rc_prog;
+} regcache_T;
+
+static regcache_T   regcache[REGCACHE_SIZE];
+static long	    regcache_tick = 0;
+
+/*
+ * Return the global state that compiling a pattern depends on, other than
+ * the pattern and flags themselves.
+ */
+    static int
+regcache_state(void)
+{
+    get_cpo_flags();
+    return (int)p_re + (reg_cpo_lit << 2) + (reg_cpo_bsl << 3)
+			   + (has_mbyte << 4) + (enc_utf8 << 5) + (enc_dbcs << 6);
+}
+
+/*
+ * Return TRUE when the prog for "expr" can be kept in the cache.  Not when
+ * compiling it depends on the previous substitute string ("~"), on
+ * 'iskeyword' and similar options ("[:keyword:]") or on syntax "\z(".
+ */
+    static int
+regcache_usable(char_u *expr)
+{
+#ifdef FEAT_SYN_HL
+    if (reg_do_extmatch != 0)
+	return FALSE;
+#endif
+    return vim_strchr(expr, '~') == NULL
+			     && strstr((char *)expr, "[:") == NULL;
+}
+
+/*
+ * Find the cache entry for "expr" with "re_flags".
+ * Returns NULL when not found.
+ */
+    static regcache_T *
+regcache_find(char_u *expr, hash_T hash, int re_flags, int state)
+{
+    int		i;
+
+    for (i = 0; i < REGCACHE_SIZE; ++i)
+	if (regcache[i].rc_pat != NULL && regcache[i].rc_hash == hash
+		&& regcache[i].rc_flags == re_flags
+		&& regcache[i].rc_state == state
+		&& STRCMP(regcache[i].rc_pat, expr) == 0)
+	    return &regcache[i];
+    return NULL;
+}
+
+/*
+ * Add "prog" compiled from "expr" to the cache, replacing the least recently
+ * used entry.
+ */
+    static void
+regcache_add(
+	char_u	    *expr,
+	hash_T	    hash,
+	int	    re_flags,
+	int	    state,
+	regprog_T   *prog)
+{
+    regcache_T	*rc = &regcache[0];
+    char_u	*pat;
+    int		i;
+
+    pat = vim_strsave(expr);
+    if (pat == NULL)
+	return;
+    for (i = 1; i < REGCACHE_SIZE && rc->rc_pat != NULL; ++i)
+	if (regcache[i].rc_pat == NULL || regcache[i].rc_used < rc->rc_used)
+	    rc = &regcache[i];
+    if (rc->rc_pat != NULL)
+    {
+	vim_free(rc->rc_pat);
+	vim_regfree(rc->rc_prog);
+    }
+    rc->rc_pat = pat;
+    rc->rc_hash = hash;
+    rc->rc_flags = re_flags;
+    rc->rc_state = state;
+    rc->rc_had_eol = had_eol;
+    rc->rc_used = ++regcache_tick;
+    rc->rc_prog = prog;
+    ++prog->re_refcount;
+}
+
+#if defined(FEAT_PROFILE) || defined(PROTO)
+/*
+ * ":regexptime": timing of compiling and executing patterns.  There is one
+ * entry for each pattern compiled while it is on.  Entries are only freed
+ * when exiting, compiled programs may point to them.
+ */
+struct regtime_S
+{
+    proftime_T	rt_comp;	// total time spent on compiling
+    long	rt_comp_count;	// nr of times compiled
+    syn_time_T	rt_exec;	// time spent on executing
+    long	rt_switched;	// nr of switches to the backtracking engine
+    char_u	rt_pat[1];	// the pattern, actually longer
+};
+
+#define HIKEY2RT(p)  ((regtime_T *)((p) - offsetof(regtime_T, rt_pat)))
+#define HI2RT(hi)    HIKEY2RT((hi)->hi_key)
+
+static int regexp_time_on = FALSE;
+static hashtab_T regtime_ht;
+static int regtime_ht_init = FALSE;
+
+/*
+ * Find the ":regexptime" entry for pattern "pat", add one if it doesn't exist
+ * yet.  Returns NULL when out of memory.
+ */
+    static regtime_T *
+regtime_find(char_u *pat)
+{
+    hash_T	hash = hash_hash(pat);
+    hashitem_T	*hi;
+    regtime_T	*rt;
+    size_t	len;
+
+    hi = hash_lookup(&regtime_ht, pat, hash);
+    if (!HASHITEM_EMPTY(hi))
+	return HI2RT(hi);
+
+    len = STRLEN(pat);
+    rt = alloc_clear(offsetof(regtime_T, rt_pat) + len + 1);
+    if (rt == NULL)
+	return NULL;
+    mch_memmove(rt->rt_pat, pat, len + 1);
+    if (hash_add_item(&regtime_ht, hi, rt->rt_pat, hash) == FAIL)
+    {
+	vim_free(rt);
+	return NULL;
+    }
+    return rt;
+}
+
+/*
+ * Add the time since "tm" was started to the execution time of "rt".
+ */
+    static void
+regtime_exec_done(regtime_T *rt, proftime_T *tm, int matched)
+{
+    syn_time_T	*st = &rt->rt_exec;
+
+    profile_end(tm);
+    profile_add(&st->total, tm);
+    if (profile_cmp(tm, &st->slowest) < 0)
+	st->slowest = *tm;
+    ++st->count;
+    if (matched)
+	++st->match;
+}
+
+    static void
+regtime_clear(void)
+{
+    long	todo = (long)regtime_ht.ht_used;
+    hashitem_T	*hi;
+    regtime_T	*rt;
+
+    for (hi = regtime_ht.ht_array; todo > 0; ++hi)
+	if (!HASHITEM_EMPTY(hi))
+	{
+	    --todo;
+	    rt = HI2RT(hi);
+	    profile_zero(&rt->rt_comp);
+	    rt->rt_comp_count = 0;
+	    profile_zero(&rt->rt_exec.total);
+	    profile_zero(&rt->rt_exec.slowest);
+	    rt->rt_exec.count = 0;
+	    rt->rt_exec.match = 0;
+	    rt->rt_switched = 0;
+	}
+}
+
+/*
+ * Sort on the total time, compiling plus executing, largest first.
+ */
+    static int
+regtime_compare(const void *v1, const void *v2)
+{
+    regtime_T	*rt1 = *(regtime_T **)v1;
+    regtime_T	*rt2 = *(regtime_T **)v2;
+    proftime_T	t1 = rt1->rt_comp;
+    proftime_T	t2 = rt2->rt_comp;
+
+    profile_add(&t1, &rt1->rt_exec.total);
+    profile_add(&t2, &rt2->rt_exec.total);
+    return profile_cmp(&t1, &t2);
+}
+
+    static void
+regtime_report(void)
+{
+    long	todo = (long)regtime_ht.ht_used;
+    hashitem_T	*hi;
+    regtime_T	*rt;
+    garray_T	ga;
+    int		idx;
+    int		len;
+    proftime_T	total_exec;
+    proftime_T	total_comp;
+    long	total_count = 0;
+    long	total_comp_count = 0;
+
+    ga_init2(&ga, sizeof(regtime_T *), 50);
+    profile_zero(&total_exec);
+    profile_zero(&total_comp);
+    for (hi = regtime_ht.ht_array; todo > 0; ++hi)
+	if (!HASHITEM_EMPTY(hi))
+	{
+	    --todo;
+	    rt = HI2RT(hi);
+	    if ((rt->rt_exec.count > 0 || rt->rt_comp_count > 0)
+							&& ga_grow(&ga, 1) == OK)
+	    {
+		((regtime_T **)ga.ga_data)[ga.ga_len++] = rt;
+		profile_add(&total_exec, &rt->rt_exec.total);
+		profile_add(&total_comp, &rt->rt_comp);
+		total_count += rt->rt_exec.count;
+		total_comp_count += rt->rt_comp_count;
+	    }
+	}
+
+    if (ga.ga_len > 1)
+	qsort(ga.ga_data, (size_t)ga.ga_len, sizeof(regtime_T *),
+							     regtime_compare);
+
+    msg_puts_title(_("  TOTAL      COUNT  MATCH   SLOWEST     COMPILE   COMPILED  SWITCHED  PATTERN"));
+    msg_puts("\n");
+    for (idx = 0; idx < ga.ga_len && !got_int; ++idx)
+    {
+	rt = ((regtime_T **)ga.ga_data)[idx];
+
+	msg_puts(profile_msg(&rt->rt_exec.total));
+	msg_puts(" "); // make sure there is always a separating space
+	msg_advance(13);
+	msg_outnum(rt->rt_exec.count);
+	msg_puts(" ");
+	msg_advance(20);
+	msg_outnum(rt->rt_exec.match);
+	msg_puts(" ");
+	msg_advance(26);
+	msg_puts(profile_msg(&rt->rt_exec.slowest));
+	msg_puts(" ");
+	msg_advance(38);
+	msg_puts(profile_msg(&rt->rt_comp));
+	msg_puts(" ");
+	msg_advance(50);
+	msg_outnum(rt->rt_comp_count);
+	msg_puts(" ");
+	msg_advance(60);
+	msg_outnum(rt->rt_switched);
+	msg_puts(" ");
+
+	msg_advance(70);
+	if (Columns < 80)
+	    len = 20; // will wrap anyway
+	else
+	    len = Columns - 70;
+	if (len > (int)STRLEN(rt->rt_pat))
+	    len = (int)STRLEN(rt->rt_pat);
+	msg_outtrans_len(rt->rt_pat, len);
+	msg_puts("\n");
+    }
+    ga_clear(&ga);
+    if (!got_int)
+    {
+	msg_puts("\n");
+	msg_puts(profile_msg(&total_exec));
+	msg_advance(13);
+	msg_outnum(total_count);
+	msg_advance(38);
+	msg_puts(profile_msg(&total_comp));
+	msg_advance(50);
+	msg_outnum(total_comp_count);
+	msg_puts("\n");
+    }
+}
+
+/*
+ * ":regexptime {on,off,clear,report}".
+ */
+    void
+ex_regexptime(exarg_T *eap)
+{
+    if (!regtime_ht_init)
+    {
+	hash_init(&regtime_ht);
+	regtime_ht_init = TRUE;
+    }
+
+    if (STRCMP(eap->arg, "on") == 0)
+	regexp_time_on = TRUE;
+    else if (STRCMP(eap->arg, "off") == 0)
+	regexp_time_on = FALSE;
+    else if (STRCMP(eap->arg, "clear") == 0)
+	regtime_clear();
+    else if (STRCMP(eap->arg, "report") == 0)
+	regtime_report();
+    else
+	semsg(_(e_invarg2), eap->arg);
+}
+#endif
+
 /*
  * Compile a regular expression into internal code.
- * Returns the program in allocated memory.
+ * Returns the program in allocated memory, which may be shared with other
+ * users of the same pattern.
  * Use vim_regfree() to free the memory.
  * Returns NULL for an error.
  */
@@ -2626,6 +3013,39 @@ vim_regcomp(char_u *expr_arg, int re_flags)
     regprog_T   *prog = NULL;
     char_u	*expr = expr_arg;
     int		called_emsg_before;
+    int		use_cache = regcache_usable(expr_arg);
+    hash_T	hash = 0;
+    int		state = 0;
+    regcache_T	*rc = NULL;
+#ifdef FEAT_PROFILE
+    proftime_T	tm;
+    int		switched = FALSE;
+
+    if (regexp_time_on)
+	profile_start(&tm);
+#endif
+
+    if (use_cache)
+    {
+	hash = hash_hash(expr_arg);
+	state = regcache_state();
+	rc = regcache_find(expr_arg, hash, re_flags, state);
+	// A prog that is being executed can't be used recursively, compile
+	// another one then.
+	if (rc != NULL && !rc->rc_prog->re_in_use)
+	{
+	    ++regcache_hits;
+	    rc->rc_used = ++regcache_tick;
+	    had_eol = rc->rc_had_eol;
+	    ++rc->rc_prog->re_refcount;
+#ifdef FEAT_PROFILE
+	    if (regexp_time_on && rc->rc_prog->re_time == NULL)
+		rc->rc_prog->re_time = regtime_find(expr_arg);
+#endif
+	    return rc->rc_prog;
+	}
+    }
+    ++regcache_misses;
 
     regexp_engine = p_re;
 
@@ -2698,6 +3118,9 @@ vim_regcomp(char_u *expr_arg, int re_flags)
 	    regexp_engine = BACKTRACKING_ENGINE;
 #ifdef FEAT_EVAL
 	    report_re_switch(expr);
+#endif
+#ifdef FEAT_PROFILE
+	    switched = TRUE;
 #endif
 	    prog = bt_regengine.regcomp(expr, re_flags);
 	}
@@ -2709,6 +3132,28 @@ vim_regcomp(char_u *expr_arg, int re_flags)
 	// out to be very slow when executing it.
 	prog->re_engine = regexp_engine;
 	prog->re_flags  = re_flags;
+	prog->re_refcount = 1;
+#ifdef FEAT_PROFILE
+	prog->re_time = NULL;
+	if (regexp_time_on)
+	{
+	    regtime_T	*rt = regtime_find(expr_arg);
+
+	    if (rt != NULL)
+	    {
+		profile_end(&tm);
+		profile_add(&rt->rt_comp, &tm);
+		++rt->rt_comp_count;
+		if (switched)
+		    ++rt->rt_switched;
+		prog->re_time = rt;
+	    }
+	}
+#endif
+
+	// Don't cache when a message was given, it would not be repeated.
+	if (use_cache && rc == NULL && called_emsg == called_emsg_before)
+	    regcache_add(expr_arg, hash, re_flags, state, prog);
     }
 
     return prog;
@@ -2716,11 +3161,12 @@ vim_regcomp(char_u *expr_arg, int re_flags)
 
 /*
  * Free a compiled regexp program, returned by vim_regcomp().
+ * The memory is only freed when there are no other users.
  */
     void
 vim_regfree(regprog_T *prog)
 {
-    if (prog != NULL)
+    if (prog != NULL && --prog->re_refcount <= 0)
 	prog->engine->regfree(prog);
 }
 
@@ -2728,8 +3174,22 @@ vim_regfree(regprog_T *prog)
     void
 free_regexp_stuff(void)
 {
+    int		i;
+
+    for (i = 0; i < REGCACHE_SIZE; ++i)
+	if (regcache[i].rc_pat != NULL)
+	{
+	    VIM_CLEAR(regcache[i].rc_pat);
+	    vim_regfree(regcache[i].rc_prog);
+	}
+# ifdef FEAT_PROFILE
+    if (regtime_ht_init)
+	hash_clear_all(&regtime_ht, offsetof(regtime_T, rt_pat));
+# endif
     ga_clear(&regstack);
     ga_clear(&backpos);
+    VIM_CLEAR(nfa_spare_t[0]);
+    VIM_CLEAR(nfa_spare_t[1]);
     vim_free(reg_tofree);
     vim_free(reg_prev_sub);
 }
@@ -2780,6 +3240,10 @@ vim_regexec_string(
     int		result;
     regexec_T	rex_save;
     int		rex_in_use_save = rex_in_use;
+#ifdef FEAT_PROFILE
+    regtime_T	*rt = NULL;
+    proftime_T	pt;
+#endif
 
     // Cannot use the same prog recursively, it contains state.
     if (rmp->regprog->re_in_use)
@@ -2788,6 +3252,13 @@ vim_regexec_string(
 	return FALSE;
     }
     rmp->regprog->re_in_use = TRUE;
+#ifdef FEAT_PROFILE
+    if (regexp_time_on && rmp->regprog->re_time != NULL)
+    {
+	rt = rmp->regprog->re_time;
+	profile_start(&pt);
+    }
+#endif
 
     if (rex_in_use)
 	// Being called recursively, save the state.
@@ -2820,6 +3291,13 @@ vim_regexec_string(
 	    rmp->regprog = vim_regcomp(pat, re_flags);
 	    if (rmp->regprog != NULL)
 	    {
+#ifdef FEAT_PROFILE
+		if (rt != NULL)
+		{
+		    ++rt->rt_switched;
+		    rmp->regprog->re_time = rt;
+		}
+#endif
 		rmp->regprog->re_in_use = TRUE;
 		result = rmp->regprog->engine->regexec_nl(rmp, line, col, nl);
 		rmp->regprog->re_in_use = FALSE;
@@ -2833,6 +3311,10 @@ vim_regexec_string(
     rex_in_use = rex_in_use_save;
     if (rex_in_use)
 	rex = rex_save;
+#ifdef FEAT_PROFILE
+    if (rt != NULL)
+	regtime_exec_done(rt, &pt, result > 0);
+#endif
 
     return result > 0;
 }
@@ -2901,6 +3383,10 @@ vim_regexec_multi(
     int		result;
     regexec_T	rex_save;
     int		rex_in_use_save = rex_in_use;
+#ifdef FEAT_PROFILE
+    regtime_T	*rt = NULL;
+    proftime_T	pt;
+#endif
 
     // Cannot use the same prog recursively, it contains state.
     if (rmp->regprog->re_in_use)
@@ -2909,6 +3395,13 @@ vim_regexec_multi(
 	return FALSE;
     }
     rmp->regprog->re_in_use = TRUE;
+#ifdef FEAT_PROFILE
+    if (regexp_time_on && rmp->regprog->re_time != NULL)
+    {
+	rt = rmp->regprog->re_time;
+	profile_start(&pt);
+    }
+#endif
 
     if (rex_in_use)
 	// Being called recursively, save the state.
@@ -2946,6 +3439,13 @@ vim_regexec_multi(
 
 	    if (rmp->regprog != NULL)
 	    {
+#ifdef FEAT_PROFILE
+		if (rt != NULL)
+		{
+		    ++rt->rt_switched;
+		    rmp->regprog->re_time = rt;
+		}
+#endif
 		rmp->regprog->re_in_use = TRUE;
 		result = rmp->regprog->engine->regexec_multi(
 				      rmp, win, buf, lnum, col, tm, timed_out);
@@ -2959,6 +3459,100 @@ vim_regexec_multi(
     rex_in_use = rex_in_use_save;
     if (rex_in_use)
 	rex = rex_save;
+#ifdef FEAT_PROFILE
+    if (rt != NULL)
+	regtime_exec_done(rt, &pt, result > 0);
+#endif
 
     return result <= 0 ? 0 : result;
 }
+
+/*
+ * Find all matches of "rmp" in lines "lnum" to "lnum_last" of buffer "buf",
+ * in one call.  These are the matches found when searching forward
+ * repeatedly: in each line the search starts in column zero and continues at
+ * the end of the match when 'cpoptions' contains 'c', otherwise one character
+ * after its start.  A match that ends in another line is the last one found
+ * in its line.
+ * The start and end of each match are appended to "gap", a growarray with
+ * lpos_T items, using buffer line numbers.
+ * Stops after finding "maxcount" matches, when it is not zero.
+ * "rmp->regprog" may be freed and changed, like with vim_regexec_multi().
+ * Returns FAIL for an error or timeout, OK otherwise.
+ */
+    int
+vim_regexec_multi_lines(
+    regmmatch_T *rmp,
+    win_T       *win,		// window in which to search or NULL
+    buf_T       *buf,		// buffer in which to search
+    linenr_T	lnum,		// first line to search
+    linenr_T	lnum_last,	// last line to search
+    int		maxcount,	// maximum number of matches or zero
+    garray_T	*gap,		// matches are appended here
+    proftime_T	*tm,		// timeout limit or NULL
+    int		*timed_out)	// flag is set when timeout limit reached
+{
+    int		called_emsg_before = called_emsg;
+    int		cpo_search = vim_strchr(p_cpo, CPO_SEARCH) != NULL;
+    long	nmatched;
+    colnr_T	col;
+    char_u	*ptr;
+    lpos_T	*pos;
+
+    for ( ; lnum <= lnum_last && !got_int; ++lnum)
+    {
+#ifdef FEAT_RELTIME
+	// Stop after passing the "tm" time limit.
+	if (tm != NULL && profile_passed_limit(tm))
+	{
+	    if (timed_out != NULL)
+		*timed_out = TRUE;
+	    return FAIL;
+	}
+#endif
+	col = 0;
+	for (;;)
+	{
+	    nmatched = vim_regexec_multi(rmp, win, buf, lnum, col,
+							       tm, timed_out);
+	    if (rmp->regprog == NULL || called_emsg > called_emsg_before
+				     || (timed_out != NULL && *timed_out))
+		return FAIL;
+	    if (nmatched == 0)
+		break;
+
+	    if (ga_grow(gap, 2) == FAIL)
+		return FAIL;
+	    pos = (lpos_T *)gap->ga_data + gap->ga_len;
+	    pos[0].lnum = lnum + rmp->startpos[0].lnum;
+	    pos[0].col = rmp->startpos[0].col;
+	    pos[1].lnum = lnum + rmp->endpos[0].lnum;
+	    pos[1].col = rmp->endpos[0].col;
+	    gap->ga_len += 2;
+	    if (maxcount > 0 && gap->ga_len >= maxcount * 2)
+		return OK;
+
+	    // Continue in the next line when the match is in a next line.
+	    if (rmp->startpos[0].lnum > 0 || (cpo_search && nmatched > 1))
+		break;
+	    ptr = ml_get_buf(buf, lnum, FALSE);
+	    if (cpo_search)
+	    {
+		col = rmp->endpos[0].col;
+		// for empty match: advance one char
+		if (col == rmp->startpos[0].col && ptr[col] != NUL)
+		    col += has_mbyte ? (*mb_ptr2len)(ptr + col) : 1;
+	    }
+	    else
+	    {
+		col = rmp->startpos[0].col;
+		if (ptr[col] != NUL)
+		    col += has_mbyte ? (*mb_ptr2len)(ptr + col) : 1;
+	    }
+	    if (ptr[col] == NUL)
+		break;
+	}
+	line_breakcheck();
+    }
+    return OK;
+}
@@ -40,6 +40,7 @@
 #define	    NFA_ENGINE		2
 
 typedef struct regengine regengine_T;
+typedef struct regtime_S regtime_T;
 
 /*
  * Structure returned by vim_regcomp() to pass on to vim_regexec().
@@ -53,6 +54,10 @@ typedef struct regprog
     unsigned		re_engine;   // automatic, backtracking or nfa engine
     unsigned		re_flags;    // second argument for vim_regcomp()
     int			re_in_use;   // prog is being executed
+    int			re_refcount; // users of the prog, see vim_regfree()
+#ifdef FEAT_PROFILE
+    regtime_T		*re_time;    // ":regexptime" entry or NULL
+#endif
 } regprog_T;
 
 /*
@@ -62,12 +67,16 @@ typedef struct regprog
  */
 typedef struct
 {
-    // These four members implement regprog_T
+    // These members implement regprog_T
     regengine_T		*engine;
     unsigned		regflags;
     unsigned		re_engine;
     unsigned		re_flags;
     int			re_in_use;
+    int			re_refcount;
+#ifdef FEAT_PROFILE
+    regtime_T		*re_time;
+#endif
 
     int			regstart;
     char_u		reganch;
@@ -84,6 +93,7 @@ typedef struct
  * An NFA state may have no outgoing edge, when it is a NFA_MATCH state.
  */
 typedef struct nfa_state nfa_state_T;
+typedef struct nfa_dfa nfa_dfa_T;
 struct nfa_state
 {
     int			c;
@@ -99,18 +109,24 @@ struct nfa_state
  */
 typedef struct
 {
-    // These three members implement regprog_T
+    // These members implement regprog_T
     regengine_T		*engine;
     unsigned		regflags;
     unsigned		re_engine;
     unsigned		re_flags;
     int			re_in_use;
+    int			re_refcount;
+#ifdef FEAT_PROFILE
+    regtime_T		*re_time;
+#endif
 
     nfa_state_T		*start;		// points into state[]
 
     int			reganch;	// pattern starts with ^
     int			regstart;	// char at start of pattern
     char_u		*match_text;	// plain text to match with
+    char_u		*regmust;	// text a match must include or NULL
+    int			regmlen;	// length of regmust
 
     int			has_zend;	// pattern contains \ze
     int			has_backref;	// pattern contains \1 .. \9
@@ -118,6 +134,7 @@ typedef struct
     int			reghasz;
 #endif
     char_u		*pattern;
+    nfa_dfa_T		*dfa;		// NULL or cached DFA states
     int			nsubexp;	// number of ()
     int			nstate;
     nfa_state_T		state[1];	// actually longer..
@@ -509,6 +509,171 @@ nfa_get_match_text(nfa_state_T *start)
     return ret;
 }
 
+// Patterns with more states are not checked for a "must appear" string.
+#define NFA_REGMUST_MAX_STATES	300
+
+/*
+ * Set "reached[]" for all states that can be reached from "start" without
+ * going through "skip".  States for which "reached[]" is already set are not
+ * followed.
+ * Returns TRUE if NFA_MATCH can be reached.
+ */
+    static int
+nfa_mark_reached(
+    nfa_regprog_T   *prog,
+    nfa_state_T	    *start,
+    nfa_state_T	    *skip,
+    char_u	    *reached,
+    nfa_state_T	    **stack)
+{
+    int		sp = 0;
+    int		found = FALSE;
+    nfa_state_T	*state;
+    nfa_state_T	*next[2];
+    int		i;
+
+    if (reached[start - prog->state])
+	return FALSE;
+    reached[start - prog->state] = TRUE;
+    stack[sp++] = start;
+    while (sp > 0)
+    {
+	state = stack[--sp];
+	next[0] = next[1] = NULL;
+	switch (state->c)
+	{
+	    case NFA_MATCH:
+		found = TRUE;
+		break;
+	    case NFA_SPLIT:
+		next[0] = state->out;
+		next[1] = state->out1;
+		break;
+	    case NFA_START_COLL:
+	    case NFA_START_NEG_COLL:
+		// out1 points to the NFA_END_COLL state
+		next[0] = state->out1->out;
+		break;
+	    default:
+		next[0] = state->out;
+		break;
+	}
+	for (i = 0; i < 2; ++i)
+	    if (next[i] != NULL && next[i] != skip
+					   && !reached[next[i] - prog->state])
+	    {
+		reached[next[i] - prog->state] = TRUE;
+		stack[sp++] = next[i];
+	    }
+    }
+    return found;
+}
+
+/*
+ * Find the longest literal text that every match must include, in the line
+ * where the match starts.  Checking that it appears in a line is much faster
+ * than trying to match.  Returns the text in allocated memory and sets
+ * "*lenp" to its length in bytes, or returns NULL.
+ */
+    static char_u *
+nfa_get_regmust(nfa_regprog_T *prog, int *lenp)
+{
+    char_u	*reached = NULL;
+    char_u	*required = NULL;
+    char_u	*after_nl = NULL;
+    nfa_state_T	**stack = NULL;
+    nfa_state_T	*p;
+    nfa_state_T	*longest = NULL;
+    int		longest_len = 0;
+    int		len;
+    int		i;
+    char_u	*ret = NULL;
+    char_u	*s;
+
+    if (prog->nstate > NFA_REGMUST_MAX_STATES)
+	return NULL;
+    for (i = 0; i < prog->nstate; ++i)
+    {
+	int c = prog->state[i].c;
+
+	// Look-around, \%[] and composing characters are too complicated.
+	if ((c >= NFA_START_INVISIBLE && c <= NFA_END_PATTERN)
+		|| c == NFA_COMPOSING || c == NFA_END_COMPOSING
+		|| c == NFA_OPT_CHARS)
+	    return NULL;
+    }
+
+    reached = alloc_clear(prog->nstate);
+    required = alloc_clear(prog->nstate);
+    after_nl = alloc_clear(prog->nstate);
+    stack = ALLOC_MULT(nfa_state_T *, prog->nstate);
+    if (reached == NULL || required == NULL || after_nl == NULL
+							       || stack == NULL)
+	goto theend;
+
+    if (!nfa_mark_reached(prog, prog->start, NULL, reached, stack))
+	goto theend;
+
+    // Text matched after a line break is in another line.
+    for (i = 0; i < prog->nstate; ++i)
+	if (prog->state[i].c == NFA_NEWL)
+	    nfa_mark_reached(prog, prog->state[i].out, NULL, after_nl, stack);
+
+    // A character is required when there is no match without it.
+    for (i = 0; i < prog->nstate; ++i)
+	if (reached[i] && prog->state[i].c > 0 && !after_nl[i])
+	{
+	    vim_memset(reached, 0, prog->nstate);
+	    required[i] = !nfa_mark_reached(prog, prog->start,
+					     &prog->state[i], reached, stack);
+	}
+
+    // Find the longest sequence of required characters that directly
+    // follow each other.  Mark the ones that follow another one in
+    // "reached[]", a sequence can't start there.
+    vim_memset(reached, 0, prog->nstate);
+    for (i = 0; i < prog->nstate; ++i)
+	if (required[i] && required[prog->state[i].out - prog->state])
+	    reached[prog->state[i].out - prog->state] = TRUE;
+    for (i = 0; i < prog->nstate; ++i)
+    {
+	if (!required[i] || reached[i])
+	    continue;
+	len = 0;
+	for (p = &prog->state[i]; required[p - prog->state]; p = p->out)
+	    len += MB_CHAR2LEN(p->c);
+	if (len > longest_len)
+	{
+	    longest = &prog->state[i];
+	    longest_len = len;
+	}
+    }
+    if (longest == NULL)
+	goto theend;
+
+    ret = alloc(longest_len + 1);
+    if (ret != NULL)
+    {
+	s = ret;
+	for (p = longest; required[p - prog->state]; p = p->out)
+	{
+	    if (has_mbyte)
+		s += (*mb_char2bytes)(p->c, s);
+	    else
+		*s++ = p->c;
+	}
+	*s = NUL;
+	*lenp = longest_len;
+    }
+
+theend:
+    vim_free(reached);
+    vim_free(required);
+    vim_free(after_nl);
+    vim_free(stack);
+    return ret;
+}
+
 /*
  * Allocate more space for post_start.  Called when
  * running above the estimated number of states.
@@ -2923,6 +3088,8 @@ nfa_dump(nfa_regprog_T *prog)
 					      prog->regstart, prog->regstart);
 	if (prog->match_text != NULL)
 	    fprintf(debugf, "match_text: \"%s\"\n", prog->match_text);
+	if (prog->regmust != NULL)
+	    fprintf(debugf, "regmust: \"%s\"\n", prog->regmust);
 
 	fclose(debugf);
     }
@@ -4080,6 +4247,14 @@ pim_info(nfa_pim_T *pim)
 
 // Used during execution: whether a match has been found.
 static int	    nfa_match;
+
+// Thread lists kept for the next call to nfa_regmatch().  Allocating and
+// freeing them for every line is slow when searching many lines.
+static nfa_thread_T *nfa_spare_t[2] = {NULL, NULL};
+static int	    nfa_spare_len[2];
+
+// Lists bigger than this many bytes are not kept.
+#define NFA_SPARE_MAX	(256 * 1024)
 #ifdef FEAT_RELTIME
 static proftime_T  *nfa_time_limit;
 static int	   *nfa_timed_out;
@@ -5334,7 +5509,7 @@ recursive_regmatch(
 		    rex.input = rex.line;
 		}
 		else
-		    rex.input = rex.line + STRLEN(rex.line);
+		    rex.input = rex.line + reg_getline_len(rex.lnum);
 	    }
 	    if ((int)(rex.input - rex.line) >= state->val)
 	    {
@@ -5706,6 +5881,7 @@ nfa_regmatch(
     int		go_to_nextline = FALSE;
     nfa_thread_T *t;
     nfa_list_T	list[2];
+    int		i;
     int		listidx;
     nfa_list_T	*thislist;
     nfa_list_T	*nextlist;
@@ -5744,10 +5920,20 @@ nfa_regmatch(
     // Allocate memory for the lists of nodes.
     size = (prog->nstate + 1) * sizeof(nfa_thread_T);
 
-    list[0].t = alloc(size);
-    list[0].len = prog->nstate + 1;
-    list[1].t = alloc(size);
-    list[1].len = prog->nstate + 1;
+    for (i = 0; i < 2; ++i)
+    {
+	if (nfa_spare_t[i] != NULL && nfa_spare_len[i] > prog->nstate)
+	{
+	    list[i].t = nfa_spare_t[i];
+	    list[i].len = nfa_spare_len[i];
+	    nfa_spare_t[i] = NULL;
+	}
+	else
+	{
+	    list[i].t = alloc(size);
+	    list[i].len = prog->nstate + 1;
+	}
+    }
     if (list[0].t == NULL || list[1].t == NULL)
 	goto theend;
 
@@ -6812,8 +6998,8 @@ nfa_regmatch(
 		{
 		    colnr_T pos_col = pos->lnum == rex.lnum + rex.reg_firstlnum
 							  && pos->col == MAXCOL
-				      ? (colnr_T)STRLEN(reg_getline(
-						pos->lnum - rex.reg_firstlnum))
+				      ? reg_getline_len(
+						pos->lnum - rex.reg_firstlnum)
 				      : pos->col;
 
 		    result = (pos->lnum == rex.lnum + rex.reg_firstlnum
@@ -7141,9 +7327,18 @@ nextchar:
 #endif
 
 theend:
-    // Free memory
-    vim_free(list[0].t);
-    vim_free(list[1].t);
+    // Keep the lists for the next call, unless they are big.  Free memory.
+    for (i = 0; i < 2; ++i)
+    {
+	if (nfa_spare_t[i] == NULL && list[i].t != NULL
+		&& list[i].len * sizeof(nfa_thread_T) <= NFA_SPARE_MAX)
+	{
+	    nfa_spare_t[i] = list[i].t;
+	    nfa_spare_len[i] = list[i].len;
+	}
+	else
+	    vim_free(list[i].t);
+    }
     vim_free(listids);
 #undef ADD_STATE_IF_MATCH
 #ifdef NFA_REGEXP_DEBUG_LOG
@@ -7293,6 +7488,471 @@ nfa_regtry(
     return 1 + rex.lnum;
 }
 
+/*
+ * Lazily built DFA, used to quickly find out that a line can't match before
+ * starting the (much slower) NFA simulation.
+ * A DFA state is the set of NFA states that consume a character, reached
+ * through empty transitions.  Zero-width items like "^", "\<" and "\%V" are
+ * assumed to always match, thus the DFA may find a match where there is none,
+ * but it never misses one.  Transitions are computed when they are first used
+ * and cached for characters below 256.
+ */
+#define NFA_DFA_MAX_STATES  64	// flush the states when there are more
+#define NFA_DFA_MAX_FLUSH   8	// stop using the DFA after this many flushes
+
+typedef struct
+{
+    int		ds_accept;	// NFA_MATCH or NFA_NEWL can be reached
+    int		ds_nids;	// number of entries in ds_ids
+    int		*ds_ids;	// sorted indexes in prog->state[]
+    short	ds_next[256];	// next DFA state for a character, -1 when
+				// not computed yet
+} nfa_dstate_T;
+
+struct nfa_dfa
+{
+    int		dfa_usable;	// FALSE when the pattern contains an item
+				// the DFA can't handle
+    int		dfa_use_chartab; // pattern uses 'iskeyword' and friends
+    int		dfa_flushes;	// number of times the states were flushed
+    int		dfa_reg_ic;	// rex.reg_ic the states were computed for
+    int		dfa_enc_utf8;	// enc_utf8 the states were computed for
+    int		dfa_chartab_tick; // chartab_tick the states were computed for
+    char_u	dfa_buf_chartab[32]; // b_chartab[] the states were computed
+				// for
+    int		dfa_nstates;	// number of entries used in dfa_states
+    nfa_dstate_T **dfa_states;	// NFA_DFA_MAX_STATES entries
+    int		dfa_nids;	// number of entries used in dfa_ids
+    int		*dfa_ids;	// "nstate" entries, used while computing
+    int		*dfa_mark;	// "nstate" entries, equal to dfa_markid when
+				// the state was added to dfa_ids
+    int		dfa_markid;
+    nfa_state_T	**dfa_stack;	// "nstate" entries, used while computing
+};
+
+/*
+ * Return TRUE if the DFA can handle NFA state "state".
+ * Sets "*use_chartab" when the state depends on 'iskeyword' and friends.
+ */
+    static int
+nfa_dfa_state_supported(nfa_state_T *state, int *use_chartab)
+{
+    int c = state->c;
+
+    if (c > 0)
+	return TRUE;
+    if (c == NFA_KWORD || c == NFA_SKWORD || c == NFA_IDENT
+	    || c == NFA_SIDENT || c == NFA_FNAME || c == NFA_SFNAME
+	    || c == NFA_PRINT || c == NFA_SPRINT || c == NFA_CLASS_IDENT
+	    || c == NFA_CLASS_KEYWORD || c == NFA_CLASS_FNAME
+	    || c == NFA_CLASS_PRINT)
+    {
+	*use_chartab = TRUE;
+	return TRUE;
+    }
+    return (c >= NFA_ANY && c <= NFA_NUPPER_IC)
+	|| (c >= NFA_MOPEN && c < NFA_ANY)	// also NFA_ZOPEN, NFA_ZCLOSE
+	|| (c >= NFA_CURSOR && c <= NFA_VISUAL)
+	|| (c >= NFA_CLASS_ALNUM && c <= NFA_CLASS_FNAME)
+	|| (c >= NFA_START_COLL && c <= NFA_END_NEG_COLL)
+	|| (c >= NFA_BOL && c <= NFA_NCLOSE)
+	|| c == NFA_RANGE_MIN || c == NFA_RANGE_MAX
+	|| c == NFA_SPLIT || c == NFA_MATCH || c == NFA_EMPTY;
+}
+
+/*
+ * Free the states of DFA "dfa".
+ */
+    static void
+nfa_dfa_flush(nfa_dfa_T *dfa)
+{
+    int i;
+
+    for (i = 0; i < dfa->dfa_nstates; ++i)
+    {
+	vim_free(dfa->dfa_states[i]->ds_ids);
+	vim_free(dfa->dfa_states[i]);
+    }
+    dfa->dfa_nstates = 0;
+}
+
+    static void
+nfa_dfa_free(nfa_dfa_T *dfa)
+{
+    if (dfa == NULL)
+	return;
+    nfa_dfa_flush(dfa);
+    vim_free(dfa->dfa_states);
+    vim_free(dfa->dfa_ids);
+    vim_free(dfa->dfa_mark);
+    vim_free(dfa->dfa_stack);
+    vim_free(dfa);
+}
+
+/*
+ * Allocate the DFA for "prog".  Returns NULL when out of memory.
+ * When the pattern contains items the DFA can't handle "dfa_usable" is FALSE.
+ */
+    static nfa_dfa_T *
+nfa_dfa_alloc(nfa_regprog_T *prog)
+{
+    nfa_dfa_T	*dfa;
+    int		i;
+
+    dfa = ALLOC_CLEAR_ONE(nfa_dfa_T);
+    if (dfa == NULL)
+	return NULL;
+
+    // Double-byte encodings are not supported, a zero byte can't be
+    // matched and anchored patterns are checked quickly already.
+    if (enc_dbcs != 0 || prog->reganch)
+	return dfa;
+    for (i = 0; i < prog->nstate; ++i)
+	if (!nfa_dfa_state_supported(&prog->state[i], &dfa->dfa_use_chartab))
+	    return dfa;
+
+    dfa->dfa_states = ALLOC_MULT(nfa_dstate_T *, NFA_DFA_MAX_STATES);
+    dfa->dfa_ids = ALLOC_MULT(int, prog->nstate);
+    dfa->dfa_mark = ALLOC_CLEAR_MULT(int, prog->nstate);
+    dfa->dfa_stack = ALLOC_MULT(nfa_state_T *, prog->nstate);
+    if (dfa->dfa_states == NULL || dfa->dfa_ids == NULL
+			  || dfa->dfa_mark == NULL || dfa->dfa_stack == NULL)
+    {
+	nfa_dfa_free(dfa);
+	return NULL;
+    }
+    dfa->dfa_usable = TRUE;
+    return dfa;
+}
+
+/*
+ * Add the NFA states that consume a character and can be reached from
+ * "start" without consuming a character to dfa->dfa_ids[].
+ * Returns TRUE when NFA_MATCH or NFA_NEWL can be reached.
+ */
+    static int
+nfa_dfa_closure(nfa_dfa_T *dfa, nfa_regprog_T *prog, nfa_state_T *start)
+{
+    int		accept = FALSE;
+    int		sp = 0;
+    nfa_state_T	*state;
+    int		id;
+
+    id = (int)(start - prog->state);
+    if (dfa->dfa_mark[id] == dfa->dfa_markid)
+	return FALSE;
+    dfa->dfa_mark[id] = dfa->dfa_markid;
+    dfa->dfa_stack[sp++] = start;
+
+    while (sp > 0)
+    {
+	state = dfa->dfa_stack[--sp];
+	switch (state->c)
+	{
+	    case NFA_MATCH:
+	    case NFA_NEWL:
+		accept = TRUE;
+		continue;
+
+	    case NFA_START_COLL:
+	    case NFA_START_NEG_COLL:
+		dfa->dfa_ids[dfa->dfa_nids++] = (int)(state - prog->state);
+		continue;
+
+	    case NFA_SPLIT:
+		id = (int)(state->out1 - prog->state);
+		if (dfa->dfa_mark[id] != dfa->dfa_markid)
+		{
+		    dfa->dfa_mark[id] = dfa->dfa_markid;
+		    dfa->dfa_stack[sp++] = state->out1;
+		}
+		break;
+
+	    default:
+		if (state->c >= 0 || (state->c >= NFA_ANY
+						   && state->c <= NFA_NUPPER_IC))
+		{
+		    dfa->dfa_ids[dfa->dfa_nids++] = (int)(state - prog->state);
+		    continue;
+		}
+		// Anything else is zero-width, assume it matches.
+		break;
+	}
+
+	id = (int)(state->out - prog->state);
+	if (dfa->dfa_mark[id] != dfa->dfa_markid)
+	{
+	    dfa->dfa_mark[id] = dfa->dfa_markid;
+	    dfa->dfa_stack[sp++] = state->out;
+	}
+    }
+    return accept;
+}
+
+/*
+ * Return TRUE if NFA state "state", which consumes a character, matches
+ * character "curc".  Must do the same as nfa_regmatch().
+ */
+    static int
+nfa_dfa_char_match(nfa_state_T *state, int curc)
+{
+    switch (state->c)
+    {
+	case NFA_START_COLL:
+	case NFA_START_NEG_COLL:
+	  {
+	    int		result_if_matched = (state->c == NFA_START_COLL);
+	    int		c1, c2;
+
+	    // Never match EOL.
+	    if (curc == NUL)
+		return FALSE;
+	    for (state = state->out; ; state = state->out)
+	    {
+		if (state->c == NFA_END_COLL)
+		    return !result_if_matched;
+		if (state->c == NFA_RANGE_MIN)
+		{
+		    c1 = state->val;
+		    state = state->out; // advance to NFA_RANGE_MAX
+		    c2 = state->val;
+		    if (curc >= c1 && curc <= c2)
+			return result_if_matched;
+		    if (rex.reg_ic)
+		    {
+			int curc_low = MB_CASEFOLD(curc);
+
+			for ( ; c1 <= c2; ++c1)
+			    if (MB_CASEFOLD(c1) == curc_low)
+				return result_if_matched;
+		    }
+		}
+		else if (state->c < 0 ? check_char_class(state->c, curc)
+			   : (curc == state->c
+			       || (rex.reg_ic && MB_CASEFOLD(curc)
+						    == MB_CASEFOLD(state->c))))
+		    return result_if_matched;
+	    }
+	  }
+
+	case NFA_ANY:	    return curc > 0;
+	case NFA_IDENT:	    return vim_isIDc(curc);
+	case NFA_SIDENT:    return !VIM_ISDIGIT(curc) && vim_isIDc(curc);
+	case NFA_KWORD:	    return vim_iswordc_buf(curc, rex.reg_buf);
+	case NFA_SKWORD:    return !VIM_ISDIGIT(curc)
+				       && vim_iswordc_buf(curc, rex.reg_buf);
+	case NFA_FNAME:	    return vim_isfilec(curc);
+	case NFA_SFNAME:    return !VIM_ISDIGIT(curc) && vim_isfilec(curc);
+	case NFA_PRINT:	    return vim_isprintc(curc);
+	case NFA_SPRINT:    return !VIM_ISDIGIT(curc) && vim_isprintc(curc);
+	case NFA_WHITE:	    return VIM_ISWHITE(curc);
+	case NFA_NWHITE:    return curc != NUL && !VIM_ISWHITE(curc);
+	case NFA_DIGIT:	    return ri_digit(curc);
+	case NFA_NDIGIT:    return curc != NUL && !ri_digit(curc);
+	case NFA_HEX:	    return ri_hex(curc);
+	case NFA_NHEX:	    return curc != NUL && !ri_hex(curc);
+	case NFA_OCTAL:	    return ri_octal(curc);
+	case NFA_NOCTAL:    return curc != NUL && !ri_octal(curc);
+	case NFA_WORD:	    return ri_word(curc);
+	case NFA_NWORD:	    return curc != NUL && !ri_word(curc);
+	case NFA_HEAD:	    return ri_head(curc);
+	case NFA_NHEAD:	    return curc != NUL && !ri_head(curc);
+	case NFA_ALPHA:	    return ri_alpha(curc);
+	case NFA_NALPHA:    return curc != NUL && !ri_alpha(curc);
+	case NFA_LOWER:	    return ri_lower(curc);
+	case NFA_NLOWER:    return curc != NUL && !ri_lower(curc);
+	case NFA_UPPER:	    return ri_upper(curc);
+	case NFA_NUPPER:    return curc != NUL && !ri_upper(curc);
+	case NFA_LOWER_IC:  return ri_lower(curc)
+					       || (rex.reg_ic && ri_upper(curc));
+	case NFA_NLOWER_IC: return curc != NUL
+			    && !(ri_lower(curc) || (rex.reg_ic && ri_upper(curc)));
+	case NFA_UPPER_IC:  return ri_upper(curc)
+					       || (rex.reg_ic && ri_lower(curc));
+	case NFA_NUPPER_IC: return curc != NUL
+			    && !(ri_upper(curc) || (rex.reg_ic && ri_lower(curc)));
+
+	default:	    // regular character
+	    return state->c == curc
+		       || (rex.reg_ic && MB_CASEFOLD(state->c)
+							 == MB_CASEFOLD(curc));
+    }
+}
+
+/*
+ * Find or add the DFA state for the NFA states in dfa->dfa_ids[].
+ * Returns the index of the state, -1 when there are too many states.
+ */
+    static int
+nfa_dfa_add_state(nfa_dfa_T *dfa, int accept)
+{
+    nfa_dstate_T    *ds;
+    int		    i, j, tmp;
+
+    // Sort the ids, there usually are only a few.
+    for (i = 1; i < dfa->dfa_nids; ++i)
+	for (j = i; j > 0 && dfa->dfa_ids[j - 1] > dfa->dfa_ids[j]; --j)
+	{
+	    tmp = dfa->dfa_ids[j];
+	    dfa->dfa_ids[j] = dfa->dfa_ids[j - 1];
+	    dfa->dfa_ids[j - 1] = tmp;
+	}
+
+    for (i = 0; i < dfa->dfa_nstates; ++i)
+    {
+	ds = dfa->dfa_states[i];
+	if (ds->ds_accept == accept && ds->ds_nids == dfa->dfa_nids
+		&& memcmp(ds->ds_ids, dfa->dfa_ids,
+					  sizeof(int) * dfa->dfa_nids) == 0)
+	    return i;
+    }
+
+    if (dfa->dfa_nstates == NFA_DFA_MAX_STATES)
+	return -1;
+    ds = ALLOC_ONE(nfa_dstate_T);
+    if (ds == NULL)
+	return -1;
+    ds->ds_ids = ALLOC_MULT(int, dfa->dfa_nids + 1);
+    if (ds->ds_ids == NULL)
+    {
+	vim_free(ds);
+	return -1;
+    }
+    mch_memmove(ds->ds_ids, dfa->dfa_ids, sizeof(int) * dfa->dfa_nids);
+    ds->ds_nids = dfa->dfa_nids;
+    ds->ds_accept = accept;
+    vim_memset(ds->ds_next, -1, sizeof(ds->ds_next));
+    dfa->dfa_states[dfa->dfa_nstates] = ds;
+    return dfa->dfa_nstates++;
+}
+
+/*
+ * Compute the DFA state reached from state "ds" with character "curc".
+ * Since the match may start anywhere the start state is always included.
+ * Returns the index of the state, -1 when there are too many states.
+ */
+    static int
+nfa_dfa_step(nfa_dfa_T *dfa, nfa_regprog_T *prog, nfa_dstate_T *ds, int curc)
+{
+    int		accept = FALSE;
+    int		i;
+    nfa_state_T	*state;
+
+    ++dfa->dfa_markid;
+    dfa->dfa_nids = 0;
+    for (i = 0; i < ds->ds_nids; ++i)
+    {
+	state = &prog->state[ds->ds_ids[i]];
+	if (nfa_dfa_char_match(state, curc))
+	{
+	    // For a collection the next state is in out of the
+	    // NFA_END_COLL, out1 of START points to the END state.
+	    if (state->c == NFA_START_COLL || state->c == NFA_START_NEG_COLL)
+		state = state->out1;
+	    if (nfa_dfa_closure(dfa, prog, state->out))
+		accept = TRUE;
+	}
+    }
+    if (nfa_dfa_closure(dfa, prog, prog->start))
+	accept = TRUE;
+    return nfa_dfa_add_state(dfa, accept);
+}
+
+/*
+ * Return FALSE if "prog" can't match in rex.line at or after column "col".
+ * Returns TRUE if there might be a match, the NFA has to find out.
+ */
+    static int
+nfa_dfa_may_match(nfa_regprog_T *prog, colnr_T col)
+{
+    nfa_dfa_T	    *dfa = prog->dfa;
+    nfa_dstate_T    *ds;
+    char_u	    *p;
+    int		    c;
+    int		    len;
+    int		    next;
+
+    if (dfa == NULL)
+    {
+	dfa = prog->dfa = nfa_dfa_alloc(prog);
+	if (dfa == NULL)
+	    return TRUE;
+    }
+    if (!dfa->dfa_usable)
+	return TRUE;
+
+    // The states depend on 'ignorecase' and on the character tables.
+    if (dfa->dfa_reg_ic != rex.reg_ic || dfa->dfa_enc_utf8 != enc_utf8
+	    || (dfa->dfa_use_chartab
+		&& (dfa->dfa_chartab_tick != chartab_tick
+		    || memcmp(dfa->dfa_buf_chartab, rex.reg_buf->b_chartab,
+					     sizeof(dfa->dfa_buf_chartab)) != 0)))
+    {
+	nfa_dfa_flush(dfa);
+	dfa->dfa_reg_ic = rex.reg_ic;
+	dfa->dfa_enc_utf8 = enc_utf8;
+	if (dfa->dfa_use_chartab)
+	{
+	    dfa->dfa_chartab_tick = chartab_tick;
+	    mch_memmove(dfa->dfa_buf_chartab, rex.reg_buf->b_chartab,
+					       sizeof(dfa->dfa_buf_chartab));
+	}
+    }
+
+    if (dfa->dfa_nstates == 0)
+    {
+	++dfa->dfa_markid;
+	dfa->dfa_nids = 0;
+	if (nfa_dfa_add_state(dfa, nfa_dfa_closure(dfa, prog, prog->start))
+									  < 0)
+	    return TRUE;
+    }
+    ds = dfa->dfa_states[0];
+
+    for (p = rex.line + col; !ds->ds_accept; p += len)
+    {
+	if (*p == NUL)
+	    return FALSE;
+	if (enc_utf8 && (p[0] >= 0x80 || p[1] >= 0x80))
+	{
+	    // Composing characters are complicated, let the NFA handle them.
+	    c = utf_ptr2char(p);
+	    len = utf_ptr2len(p);
+	    if (utf_iscomposing(c) || utfc_ptr2len(p) != len)
+		return TRUE;
+	}
+	else if (has_mbyte)
+	{
+	    c = (*mb_ptr2char)(p);
+	    len = (*mb_ptr2len)(p);
+	}
+	else
+	{
+	    c = *p;
+	    len = 1;
+	}
+
+	next = c < 256 ? ds->ds_next[c] : -1;
+	if (next < 0)
+	{
+	    next = nfa_dfa_step(dfa, prog, ds, c);
+	    if (next < 0)
+	    {
+		// Too many states, start all over next time.  Give up when
+		// this keeps happening.
+		nfa_dfa_flush(dfa);
+		if (++dfa->dfa_flushes >= NFA_DFA_MAX_FLUSH)
+		    dfa->dfa_usable = FALSE;
+		return TRUE;
+	    }
+	    if (c < 256)
+		ds->ds_next[c] = next;
+	}
+	ds = dfa->dfa_states[next];
+    }
+    return TRUE;
+}
+
 /*
  * Match a regexp against a string ("line" points to the string) or multiple
  * lines (if "line" is NULL, use reg_getline()).
@@ -7389,6 +8049,16 @@ nfa_regexec_both(
     if (rex.reg_maxcol > 0 && col >= rex.reg_maxcol)
 	goto theend;
 
+    // If there is a "must appear" string, look for it.
+    if (prog->regmust != NULL && !rex.reg_icombine
+	      && find_regmust(rex.line + col, prog->regmust, &prog->regmlen)
+								      == NULL)
+	goto theend;
+
+    // Quickly check with the DFA that there can be a match in this line.
+    if (!nfa_dfa_may_match(prog, col))
+	goto theend;
+
     // Set the "nstate" used by nfa_regcomp() to zero to trigger an error when
     // it's accidentally used during execution.
     nstate = 0;
@@ -7489,6 +8159,7 @@ nfa_regcomp(char_u *expr, int re_flags)
 	goto fail;
     state_ptr = prog->state;
     prog->re_in_use = FALSE;
+    prog->dfa = NULL;
 
     /*
      * PASS 2
@@ -7510,6 +8181,17 @@ nfa_regcomp(char_u *expr, int re_flags)
     prog->reganch = nfa_get_reganch(prog->start, 0);
     prog->regstart = nfa_get_regstart(prog->start, 0);
     prog->match_text = nfa_get_match_text(prog->start);
+    prog->regmust = NULL;
+    prog->regmlen = 0;
+    // Only when there is no regstart or the string is longer, otherwise
+    // skip_to_start() does the same work.
+    if (prog->match_text == NULL)
+    {
+	prog->regmust = nfa_get_regmust(prog, &prog->regmlen);
+	if (prog->regmust != NULL && prog->regstart != NUL
+			      && prog->regmlen <= MB_CHAR2LEN(prog->regstart))
+	    VIM_CLEAR(prog->regmust);
+    }
 
 #ifdef ENABLE_LOG
     nfa_postfix_dump(expr, OK);
@@ -7550,7 +8232,9 @@ nfa_regfree(regprog_T *prog)
     if (prog != NULL)
     {
 	vim_free(((nfa_regprog_T *)prog)->match_text);
+	vim_free(((nfa_regprog_T *)prog)->regmust);
 	vim_free(((nfa_regprog_T *)prog)->pattern);
+	nfa_dfa_free(((nfa_regprog_T *)prog)->dfa);
 	vim_free(prog);
     }
 }
@@ -35,6 +35,7 @@ typedef struct searchstat
 
 static void cmdline_search_stat(int dirc, pos_T *pos, pos_T *cursor_pos, int show_top_bot_msg, char_u *msgbuf, int recompute, int maxcount, long timeout);
 static void update_search_stat(int dirc, pos_T *pos, pos_T *cursor_pos, searchstat_T *stat, int recompute, int maxcount, long timeout);
+static void count_all_matches(regmmatch_T *regmatch, pos_T *pos, int maxcount, proftime_T *tm, int *cntp, int *curp, int *exact_matchp, int *incompletep, pos_T *lastpos);
 
 #define SEARCH_STAT_DEF_TIMEOUT 40L
 #define SEARCH_STAT_DEF_MAX_COUNT 99
@@ -1021,8 +1022,7 @@ searchit(
 			    if (pos->lnum > 1)  // just in case
 			    {
 				--pos->lnum;
-				pos->col = (colnr_T)STRLEN(ml_get_buf(buf,
-							   pos->lnum, FALSE));
+				pos->col = ml_get_buf_len(buf, pos->lnum);
 			    }
 			}
 			else
@@ -1157,7 +1157,7 @@ searchit(
     if (pos->lnum > buf->b_ml.ml_line_count)
     {
 	pos->lnum = buf->b_ml.ml_line_count;
-	pos->col = (int)STRLEN(ml_get_buf(buf, pos->lnum, FALSE));
+	pos->col = ml_get_buf_len(buf, pos->lnum);
 	if (pos->col > 0)
 	    --pos->col;
     }
@@ -3199,6 +3199,58 @@ cmdline_search_stat(
     }
 }
 
+/*
+ * Count the matches of "regmatch" in the current buffer, for
+ * update_search_stat().  Sets "*curp" to the number of the match at or
+ * before "pos" and "*lastpos" to the start of the last match.
+ */
+    static void
+count_all_matches(
+    regmmatch_T	*regmatch,
+    pos_T	*pos,
+    int		maxcount,
+    proftime_T	*tm,
+    int		*cntp,
+    int		*curp,
+    int		*exact_matchp,
+    int		*incompletep,
+    pos_T	*lastpos)
+{
+    garray_T	ga;
+    lpos_T	*matches;
+    pos_T	endpos = {0, 0, 0};
+    int		i;
+    int		timed_out = FALSE;
+
+    ga_init2(&ga, sizeof(lpos_T), 100);
+    if (vim_regexec_multi_lines(regmatch, curwin, curbuf, 1,
+		curbuf->b_ml.ml_line_count, maxcount > 0 ? maxcount + 1 : 0,
+					     &ga, tm, &timed_out) == FAIL
+								&& timed_out)
+	*incompletep = 1;
+    matches = (lpos_T *)ga.ga_data;
+    for (i = 0; i + 1 < ga.ga_len; i += 2)
+    {
+	++*cntp;
+	lastpos->lnum = matches[i].lnum;
+	lastpos->col = matches[i].col;
+	endpos.lnum = matches[i + 1].lnum;
+	endpos.col = matches[i + 1].col;
+	if (LTOREQ_POS(*lastpos, *pos))
+	{
+	    *curp = *cntp;
+	    if (LT_POS(*pos, endpos))
+		*exact_matchp = TRUE;
+	}
+	if (maxcount > 0 && *cntp > maxcount)
+	{
+	    *incompletep = 2;    // max count exceeded
+	    break;
+	}
+    }
+    ga_clear(&ga);
+}
+
 /*
  * Add the search count information to "stat".
  * "stat" must not be NULL.
@@ -3274,15 +3326,44 @@ update_search_stat(
     else
     {
 	int	done_search = FALSE;
+	int	batched = FALSE;
 	pos_T	endpos = {0, 0, 0};
+	regmmatch_T regmatch;
 
 	p_ws = FALSE;
 #ifdef FEAT_RELTIME
 	if (timeout > 0)
 	    profile_setlimit(timeout, &start);
 #endif
-	while (!got_int && searchit(curwin, curbuf, &lastpos, &endpos,
-			 FORWARD, NULL, 1, SEARCH_KEEP, RE_LAST, NULL) != FAIL)
+	// Counting from the start: find all the matches in one go, that is a
+	// lot faster than calling searchit() for each match.  Not for a
+	// pattern that can match a line break, then searchit() may find a
+	// match that starts in another line.
+	if (EMPTY_POS(lastpos))
+	{
+	    if (search_regcomp(NULL, RE_SEARCH, RE_LAST, SEARCH_KEEP,
+							   &regmatch) == FAIL)
+		batched = TRUE;	    // error message was given
+	    else
+	    {
+		if (!re_multiline(regmatch.regprog))
+		{
+		    batched = TRUE;
+		    count_all_matches(&regmatch, &p, maxcount,
+#ifdef FEAT_RELTIME
+			    timeout > 0 ? &start : NULL,
+#else
+			    NULL,
+#endif
+			    &cnt, &cur, &exact_match, &incomplete, &lastpos);
+		    done_search = cnt > 0;
+		}
+		vim_regfree(regmatch.regprog);
+	    }
+	}
+	while (!batched && !got_int && searchit(curwin, curbuf, &lastpos,
+		       &endpos, FORWARD, NULL, 1, SEARCH_KEEP, RE_LAST, NULL)
+								      != FAIL)
 	{
 	    done_search = TRUE;
 #ifdef FEAT_RELTIME
@@ -497,6 +497,12 @@ typedef struct mf_hashtab_S
  * The used list is a doubly linked list, most recently used block first.
  *	The blocks in the used list have a block of memory allocated.
  *	mf_used_count is the number of pages in the used list.
+ *	The list has a hot part followed by a cold part, mf_cold_first is the
+ *	first block in the cold part.  A block that is created or read from
+ *	the file goes in front of the cold part, only when it is used again
+ *	while in memory it moves to the hot part.  Blocks are released from
+ *	the end of the list, thus a scan through many blocks does not push
+ *	out the blocks that are used over and over.
  * The hash lists are used to quickly find a block in the used list.
  * The free list is a single linked list, not sorted.
  *	The blocks in the free list have no block of memory allocated and
@@ -515,7 +521,8 @@ struct block_hdr
 
 #define BH_DIRTY    1
 #define BH_LOCKED   2
-    char	bh_flags;	    // BH_DIRTY or BH_LOCKED
+#define BH_HOT	    4		    // in the hot part of the used list
+    char	bh_flags;	    // BH_DIRTY, BH_LOCKED or BH_HOT
 };
 
 /*
@@ -679,8 +686,14 @@ struct memfile
     bhdr_T	*mf_free_first;		// first block_hdr in free list
     bhdr_T	*mf_used_first;		// mru block_hdr in used list
     bhdr_T	*mf_used_last;		// lru block_hdr in used list
+    bhdr_T	*mf_cold_first;		// mru block_hdr in cold part of used
+					// list, NULL if it's empty
     unsigned	mf_used_count;		// number of pages in used list
+    unsigned	mf_hot_count;		// number of pages in hot part
     unsigned	mf_used_count_max;	// maximum number of pages in memory
+    long	mf_hits;		// mf_get() found block in memory
+    long	mf_misses;		// mf_get() had to read block from file
+    long	mf_evictions;		// blocks released to make room
     mf_hashtab_T mf_hash;		// hash lists
     mf_hashtab_T mf_trans;		// trans lists
     blocknr_T	mf_blocknr_max;		// highest positive block number + 1
@@ -689,6 +702,8 @@ struct memfile
     blocknr_T	mf_infile_count;	// number of pages in the file
     unsigned	mf_page_size;		// number of bytes in a page
     int		mf_dirty;		// TRUE if there are dirty blocks
+    int		mf_need_flush;		// TRUE if blocks were written but not
+					// flushed to disk
 #ifdef FEAT_CRYPT
     buf_T	*mf_buffer;		// buffer this memfile is for
     char_u	mf_seed[MF_SEED_LEN];	// seed for encryption
@@ -752,6 +767,9 @@ typedef struct memline
     int		ml_flags;
 
     colnr_T	ml_line_len;	// length of the cached line, including NUL
+    colnr_T	ml_line_textlen; // length of the cached line text, including
+				// NUL, without text properties; zero if
+				// not known
     linenr_T	ml_line_lnum;	// line number of cached line, 0 if not valid
     char_u	*ml_line_ptr;	// pointer to cached line
 
@@ -763,6 +781,9 @@ typedef struct memline
     chunksize_T *ml_chunksize;
     int		ml_numchunks;
     int		ml_usedchunks;
+    chunksize_T *ml_chunktree;	// Fenwick tree over ml_chunksize
+    int		ml_chunktree_size;  // number of entries in ml_chunktree
+    int		ml_chunktree_valid; // ml_chunktree matches ml_chunksize
 #endif
 } memline_T;
 
@@ -2560,6 +2581,8 @@ typedef struct {
 #ifdef FEAT_SYN_HL
     hashtab_T	b_keywtab;		// syntax keywords hash table
     hashtab_T	b_keywtab_ic;		// idem, ignore case
+    unsigned	*b_keywlens;		// keyword lengths by first byte or
+					// NULL, see syn_keyword_lens()
     int		b_syn_error;		// TRUE when error occurred in HL
 # ifdef FEAT_RELTIME
     int		b_syn_slow;		// TRUE when 'redrawtime' reached
@@ -2605,6 +2628,8 @@ typedef struct {
      * b_sst_freecount	number of free entries in b_sst_array[]
      * b_sst_check_lnum	entries after this lnum need to be checked for
      *			validity (MAXLNUM means no check needed)
+     * b_sst_idle_lnum	line up to where states were stored while waiting
+     *			for a character (MAXLNUM when it failed)
      */
     synstate_T	*b_sst_array;
     int		b_sst_len;
@@ -2612,6 +2637,7 @@ typedef struct {
     synstate_T	*b_sst_firstfree;
     int		b_sst_freecount;
     linenr_T	b_sst_check_lnum;
+    linenr_T	b_sst_idle_lnum;
     short_u	b_sst_lasttick;	// last display tick
 #endif // FEAT_SYN_HL
 
@@ -2783,6 +2809,18 @@ struct file_buffer
     long	b_u_seq_cur;	// hu_seq of header below which we are now
     time_T	b_u_time_cur;	// uh_time of header below which we are now
     long	b_u_save_nr_cur; // file write nr after which we are now
+#ifdef FEAT_PERSISTENT_UNDO
+    // State of the undo file as last written or read, used to append only
+    // the new headers.  b_u_file_seq is zero when it must be rewritten.
+    long	b_u_file_seq;	// b_u_seq_last when the undo file was written
+    long	b_u_file_newhead; // uh_seq of b_u_newhead at that time
+    off_T	b_u_file_base;	// size of the fully written part
+    off_T	b_u_file_size;	// size of the undo file
+    time_T	b_u_file_mtime;	// modification time of the undo file
+# ifdef UNIX
+    ino_t	b_u_file_ino;	// inode number of the undo file
+# endif
+#endif
 
     /*
      * variables for "U" command in undo.c
@@ -3100,6 +3138,13 @@ struct file_buffer
     synblock_T	b_s;		// Info related to syntax highlighting.  w_s
 				// normally points to this, but some windows
 				// may use a different synblock_T.
+# if defined(FEAT_SYN_HL) && defined(FEAT_PERSISTENT_UNDO)
+    int		b_syn_cache_read; // TRUE when syntax states may be read
+				  // from the syntax cache file
+    int		b_syn_cache_hash_ok; // TRUE when b_syn_cache_hash is set
+    char_u	b_syn_cache_hash[UNDO_HASH_SIZE]; // hash of the text when the
+				  // undo file was last read or written
+# endif
 #endif
 
 #ifdef FEAT_SIGNS
@@ -95,6 +95,14 @@ typedef struct syn_pattern
 
 #define MAXKEYWLEN	80	    // maximum length of a keyword
 
+// Bit in b_keywlens[] for a keyword of "len" bytes.
+#define KEYWLEN_BIT(len)    (1u << ((len) < 31 ? (len) : 31))
+
+// Like vim_iswordp_buf(p, syn_buf), quicker for ASCII.
+#define SYN_ISWORDP(p)	(*(p) < 0x80 \
+			    ? *(p) != NUL && GET_CHARTAB(syn_buf, *(p)) != 0 \
+			    : vim_iswordp_buf((p), syn_buf))
+
 /*
  * The attributes of the syntax item that has been recognized.
  */
@@ -270,6 +278,8 @@ static buf_T	*syn_buf;		// current buffer for highlighting
 static synblock_T *syn_block;		// current buffer for highlighting
 #ifdef FEAT_RELTIME
 static proftime_T *syn_tm;		// timeout limit
+static int	syn_idle = FALSE;	// parsing while waiting for a char
+static int	syn_idle_timed_out;	// syn_tm passed while "syn_idle" set
 #endif
 static linenr_T current_lnum = 0;	// lnum of current state
 static colnr_T	current_col = 0;	// column of current state
@@ -284,6 +294,11 @@ static int	current_line_id = 0;	// unique number for current line
 
 #define CUR_STATE(idx)	((stateitem_T *)(current_state.ga_data))[idx]
 
+static void syn_stack_free_block(synblock_T *block);
+static int syn_stack_dist(synblock_T *block, buf_T *buf);
+#ifdef FEAT_PERSISTENT_UNDO
+static void syn_cache_read(void);
+#endif
 static void syn_sync(win_T *wp, linenr_T lnum, synstate_T *last_valid);
 static int syn_match_linecont(linenr_T lnum);
 static void syn_start_line(void);
@@ -330,6 +345,7 @@ static void syn_add_start_off(lpos_T *result, regmmatch_T *regmatch, synpat_T *s
 static char_u *syn_getcurline(void);
 static int syn_regexec(regmmatch_T *rmp, linenr_T lnum, colnr_T col, syn_time_T *st);
 static int check_keyword_id(char_u *line, int startcol, int *endcol, long *flags, short **next_list, stateitem_T *cur_si, int *ccharp);
+static unsigned *syn_keyword_lens(void);
 static void syn_remove_pattern(synblock_T *block, int idx);
 static void syn_clear_pattern(synblock_T *block, int i);
 static void syn_clear_cluster(synblock_T *block, int i);
@@ -411,6 +427,16 @@ syntax_start(win_T *wp, linenr_T lnum)
 	return;		// out of memory
     syn_block->b_sst_lasttick = display_tick;
 
+#ifdef FEAT_PERSISTENT_UNDO
+    // After reading a file the states may be in the syntax cache file.
+    if (syn_buf->b_syn_cache_read)
+    {
+	syn_buf->b_syn_cache_read = FALSE;
+	if (syn_block == &syn_buf->b_s && syn_block->b_sst_first == NULL)
+	    syn_cache_read();
+    }
+#endif
+
     /*
      * If the state of the end of the previous line is useful, store it.
      */
@@ -480,10 +506,7 @@ syntax_start(win_T *wp, linenr_T lnum)
      * Advance from the sync point or saved state until the current line.
      * Save some entries for syncing with later on.
      */
-    if (syn_block->b_sst_len <= Rows)
-	dist = 999999;
-    else
-	dist = syn_buf->b_ml.ml_line_count / (syn_block->b_sst_len - Rows) + 1;
+    dist = syn_stack_dist(syn_block, syn_buf);
     while (current_lnum < lnum)
     {
 	syn_start_line();
@@ -546,6 +569,543 @@ syntax_start(win_T *wp, linenr_T lnum)
     syn_start_line();
 }
 
+#if defined(FEAT_RELTIME) || defined(PROTO)
+/*
+ * Return TRUE when states for the current window can be computed while
+ * waiting for the user to type.  Only when jumping to a line would otherwise
+ * parse more lines than there are between stored states, e.g. for ":syn sync
+ * fromstart".  Not when the buffer was changed and the screen was not updated
+ * yet, the stored states have not been adjusted for the change then.
+ */
+    int
+syntax_idle_pending(void)
+{
+    synblock_T	*block = curwin->w_s;
+    int		dist;
+
+    if (!syntax_present(curwin) || block->b_syn_slow
+	    || block->b_sst_array == NULL
+	    || curbuf->b_ml.ml_mfp == NULL
+	    || curbuf->b_mod_set
+	    || block->b_sst_idle_lnum >= curbuf->b_ml.ml_line_count)
+	return FALSE;
+    dist = syn_stack_dist(block, curbuf);
+    return block->b_syn_sync_minlines > dist
+	    || ((block->b_syn_sync_flags & SF_MATCH)
+		&& (block->b_syn_sync_maxlines == 0
+				       || block->b_syn_sync_maxlines > dist));
+}
+
+/*
+ * Parse the syntax of the current window ahead of what is displayed, for
+ * about "msec" msec.  Called while waiting for the user to type.  States are
+ * stored every so many lines, so that displaying any line later only needs
+ * to parse from the nearest one.
+ */
+    void
+syntax_idle_parse(long msec)
+{
+    synblock_T	*block = curwin->w_s;
+    proftime_T	slice_tm;
+    proftime_T	tm;
+    linenr_T	lnum = block->b_sst_idle_lnum;
+
+    profile_setlimit(msec, &slice_tm);
+    // Give up when this takes longer than 'redrawtime', a regexp must be
+    // very slow then.
+    profile_setlimit(p_rdt, &tm);
+    syn_tm = &tm;
+    syn_idle = TRUE;
+    syn_idle_timed_out = FALSE;
+
+    while (lnum < curbuf->b_ml.ml_line_count)
+    {
+	lnum += syn_stack_dist(block, curbuf);
+	if (lnum > curbuf->b_ml.ml_line_count)
+	    lnum = curbuf->b_ml.ml_line_count;
+	syntax_start(curwin, lnum);
+	if (got_int || syn_idle_timed_out)
+	    break;
+	block->b_sst_idle_lnum = lnum;
+	if (profile_passed_limit(&slice_tm))
+	    break;
+    }
+
+    syn_idle = FALSE;
+    syn_tm = NULL;
+    if (got_int || syn_idle_timed_out)
+    {
+	// The state is wrong after an interrupted or failed match.
+	invalidate_current_state();
+	if (syn_idle_timed_out)
+	{
+	    // Stored states may be wrong, and don't try again.
+	    syn_stack_free_block(block);
+	    block->b_sst_idle_lnum = MAXLNUM;
+	}
+    }
+}
+#endif
+
+#if defined(FEAT_PERSISTENT_UNDO) || defined(PROTO)
+/*
+ * The syntax cache file stores the states of a buffer, so that they can be
+ * used again when the same text is read with the same syntax items.  It is
+ * written next to the undofile, only when 'undofile' is set.
+ *
+ * File layout, numbers MSB first:
+ * SYN_CACHE_MAGIC, version (1 byte)
+ * hash of the syntax items, hash of the text (UNDO_HASH_SIZE bytes each)
+ * number of states (4 bytes), then for each state:
+ *	line number, sst_next_flags, index of the item with sst_next_list
+ *	plus one (zero for none), sst_stacksize (4 bytes each), then for each
+ *	stack entry bs_idx, bs_flags, bs_seqnr, bs_cchar (4 bytes each)
+ */
+# define SYN_CACHE_MAGIC	"VimSyn\n"
+# define SYN_CACHE_MAGIC_LEN	7
+# define SYN_CACHE_VERSION	1
+
+    static void
+syn_hash_nr(context_sha256_T *ctx, long nr)
+{
+    char_u	buf[4];
+
+    buf[0] = (char_u)(nr >> 24);
+    buf[1] = (char_u)(nr >> 16);
+    buf[2] = (char_u)(nr >> 8);
+    buf[3] = (char_u)nr;
+    sha256_update(ctx, buf, 4);
+}
+
+    static void
+syn_hash_str(context_sha256_T *ctx, char_u *s)
+{
+    if (s == NULL)
+	s = (char_u *)"";
+    sha256_update(ctx, s, (UINT32_T)(STRLEN(s) + 1));
+}
+
+    static void
+syn_hash_list(context_sha256_T *ctx, short *list)
+{
+    if (list != NULL)
+	while (*list != 0)
+	    syn_hash_nr(ctx, *list++);
+    syn_hash_nr(ctx, 0);
+}
+
+/*
+ * Compute a hash over everything in "block" of "buf" that the stored syntax
+ * states depend on into hash[UNDO_HASH_SIZE].
+ */
+    static void
+syn_cache_def_hash(synblock_T *block, buf_T *buf, char_u *hash)
+{
+    context_sha256_T	ctx;
+    synpat_T		*spp;
+    hashtab_T		*ht;
+    hashitem_T		*hi;
+    keyentry_T		*kp;
+    long		todo;
+    int			i, j;
+
+    sha256_start(&ctx);
+    syn_hash_str(&ctx, p_enc);
+    syn_hash_str(&ctx, buf->b_p_isk);
+    syn_hash_str(&ctx, block->b_syn_isk);
+    syn_hash_nr(&ctx, block->b_syn_ic);
+    syn_hash_nr(&ctx, block->b_syn_containedin);
+    syn_hash_nr(&ctx, block->b_syn_sync_flags);
+    if (block->b_syn_sync_flags & SF_CCOMMENT)
+	syn_hash_nr(&ctx, block->b_syn_sync_id);
+    syn_hash_nr(&ctx, block->b_syn_sync_minlines);
+    syn_hash_nr(&ctx, block->b_syn_sync_maxlines);
+    syn_hash_nr(&ctx, block->b_syn_sync_linebreaks);
+    syn_hash_str(&ctx, block->b_syn_linecont_pat);
+    syn_hash_nr(&ctx, block->b_syn_linecont_ic);
+
+    for (i = 0; i < block->b_syn_patterns.ga_len; ++i)
+    {
+	spp = &(SYN_ITEMS(block)[i]);
+	syn_hash_nr(&ctx, spp->sp_type);
+	syn_hash_nr(&ctx, spp->sp_syncing);
+	syn_hash_nr(&ctx, spp->sp_syn_match_id);
+	syn_hash_nr(&ctx, spp->sp_off_flags);
+	for (j = 0; j < SPO_COUNT; ++j)
+	    syn_hash_nr(&ctx, spp->sp_offsets[j]);
+	syn_hash_nr(&ctx, spp->sp_flags);
+	syn_hash_nr(&ctx, spp->sp_ic);
+	syn_hash_nr(&ctx, spp->sp_sync_idx);
+	syn_hash_nr(&ctx, spp->sp_syn.inc_tag);
+	syn_hash_nr(&ctx, spp->sp_syn.id);
+	syn_hash_list(&ctx, spp->sp_syn.cont_in_list);
+	syn_hash_list(&ctx, spp->sp_cont_list);
+	syn_hash_list(&ctx, spp->sp_next_list);
+	syn_hash_str(&ctx, spp->sp_pattern);
+    }
+
+    for (i = 0; i < block->b_syn_clusters.ga_len; ++i)
+	syn_hash_list(&ctx, SYN_CLSTR(block)[i].scl_list);
+
+    for (j = 0; j < 2; ++j)
+    {
+	ht = j == 0 ? &block->b_keywtab : &block->b_keywtab_ic;
+	todo = (long)ht->ht_used;
+	for (hi = ht->ht_array; todo > 0; ++hi)
+	    if (!HASHITEM_EMPTY(hi))
+	    {
+		--todo;
+		for (kp = HI2KE(hi); kp != NULL; kp = kp->ke_next)
+		{
+		    syn_hash_str(&ctx, kp->keyword);
+		    syn_hash_nr(&ctx, kp->k_syn.inc_tag);
+		    syn_hash_nr(&ctx, kp->k_syn.id);
+		    syn_hash_list(&ctx, kp->k_syn.cont_in_list);
+		    syn_hash_list(&ctx, kp->next_list);
+		    syn_hash_nr(&ctx, kp->flags);
+		}
+	    }
+    }
+    sha256_finish(&ctx, hash);
+}
+
+/*
+ * Return TRUE when the syntax cache file can be used for "buf".  Only when
+ * there is an undo file for the text, its hash is then known.
+ */
+    static int
+syn_cache_usable(buf_T *buf)
+{
+    return buf->b_p_udf
+	    && buf->b_syn_cache_hash_ok
+	    && buf->b_ffname != NULL
+	    && buf->b_ml.ml_mfp != NULL
+	    && !bufIsChanged(buf)
+# ifdef FEAT_CRYPT
+	    && *buf->b_p_key == NUL
+# endif
+# ifdef FEAT_RELTIME
+	    && !buf->b_s.b_syn_slow
+# endif
+	    && !buf->b_s.b_syn_error
+	    && (buf->b_s.b_syn_patterns.ga_len > 0
+		|| buf->b_s.b_keywtab.ht_used > 0
+		|| buf->b_s.b_keywtab_ic.ht_used > 0);
+}
+
+/*
+ * Return the index of the syntax item that has "list" as its "nextgroup"
+ * list, -1 when there is none.
+ */
+    static int
+syn_next_list_idx(synblock_T *block, short *list)
+{
+    int		i;
+
+    for (i = 0; i < block->b_syn_patterns.ga_len; ++i)
+	if (SYN_ITEMS(block)[i].sp_next_list == list)
+	    return i;
+    return -1;
+}
+
+/*
+ * Return TRUE when state "p" can be written in the syntax cache file.
+ * States with external matches or a keyword "nextgroup" can't be restored.
+ */
+    static int
+syn_cache_state_ok(synblock_T *block, synstate_T *p, linenr_T line_count)
+{
+    bufstate_T	*bp;
+    int		i;
+
+    if (p->sst_change_lnum != 0 || p->sst_lnum > line_count
+	    || (p->sst_next_list != NULL
+			&& syn_next_list_idx(block, p->sst_next_list) < 0))
+	return FALSE;
+    if (p->sst_stacksize > SST_FIX_STATES)
+	bp = SYN_STATE_P(&(p->sst_union.sst_ga));
+    else
+	bp = p->sst_union.sst_stack;
+    for (i = 0; i < p->sst_stacksize; ++i)
+	if (bp[i].bs_extmatch != NULL)
+	    return FALSE;
+    return TRUE;
+}
+
+/*
+ * Check that "fp" starts with the header of a syntax cache file.
+ */
+    static int
+syn_cache_check_magic(FILE *fp)
+{
+    char_u	magic[SYN_CACHE_MAGIC_LEN];
+
+    return fread(magic, SYN_CACHE_MAGIC_LEN, 1, fp) == 1
+	    && memcmp(magic, SYN_CACHE_MAGIC, SYN_CACHE_MAGIC_LEN) == 0
+	    && getc(fp) == SYN_CACHE_VERSION;
+}
+
+/*
+ * Write the stored syntax states of "buf" to its syntax cache file.
+ * Called when the text of the buffer is going to be unloaded.  Nothing is
+ * done when the buffer was changed, the cache is for the text in the file.
+ */
+    void
+syn_cache_write(buf_T *buf)
+{
+    synblock_T	*block = &buf->b_s;
+    synstate_T	*p;
+    bufstate_T	*bp;
+    char_u	*file_name;
+    char_u	hash[UNDO_HASH_SIZE];
+    FILE	*fp;
+    int		fd;
+    int		perm;
+    long	count = 0;
+    int		ok = TRUE;
+    int		i;
+
+    if (!syn_cache_usable(buf) || block->b_sst_first == NULL)
+	return;
+    FOR_ALL_SYNSTATES(block, p)
+	if (syn_cache_state_ok(block, p, buf->b_ml.ml_line_count))
+	    ++count;
+    if (count == 0)
+	return;
+
+    file_name = u_get_syn_cache_name(buf->b_ffname, FALSE);
+    if (file_name == NULL)
+	return;
+
+    // Only overwrite an existing syntax cache file.
+    if (mch_getperm(file_name) >= 0)
+    {
+	fp = mch_fopen((char *)file_name, READBIN);
+	if (fp == NULL || !syn_cache_check_magic(fp))
+	    ok = FALSE;
+	if (fp != NULL)
+	    fclose(fp);
+	if (ok)
+	    mch_remove(file_name);
+    }
+    if (ok)
+    {
+	// Use the permissions of the file, like for the undofile.
+	perm = mch_getperm(buf->b_ffname);
+	if (perm < 0)
+	    perm = 0600;
+	fd = mch_open((char *)file_name,
+		       O_CREAT|O_EXTRA|O_WRONLY|O_EXCL|O_NOFOLLOW, perm & 0666);
+	fp = fd < 0 ? NULL : fdopen(fd, WRITEBIN);
+	if (fp == NULL)
+	{
+	    if (fd >= 0)
+		close(fd);
+	    ok = FALSE;
+	}
+    }
+    if (ok)
+    {
+	ok = fwrite(SYN_CACHE_MAGIC, SYN_CACHE_MAGIC_LEN, 1, fp) == 1
+			&& put_bytes(fp, (long_u)SYN_CACHE_VERSION, 1) == OK;
+	syn_cache_def_hash(block, buf, hash);
+	ok = ok && fwrite(hash, UNDO_HASH_SIZE, 1, fp) == 1;
+	ok = ok && fwrite(buf->b_syn_cache_hash, UNDO_HASH_SIZE, 1, fp) == 1
+			&& put_bytes(fp, (long_u)count, 4) == OK;
+	FOR_ALL_SYNSTATES(block, p)
+	{
+	    if (!ok)
+		break;
+	    if (!syn_cache_state_ok(block, p, buf->b_ml.ml_line_count))
+		continue;
+	    put_bytes(fp, (long_u)p->sst_lnum, 4);
+	    put_bytes(fp, (long_u)p->sst_next_flags, 4);
+	    put_bytes(fp, (long_u)(p->sst_next_list == NULL ? 0
+			: syn_next_list_idx(block, p->sst_next_list) + 1), 4);
+	    ok = put_bytes(fp, (long_u)p->sst_stacksize, 4) == OK;
+	    if (p->sst_stacksize > SST_FIX_STATES)
+		bp = SYN_STATE_P(&(p->sst_union.sst_ga));
+	    else
+		bp = p->sst_union.sst_stack;
+	    for (i = 0; ok && i < p->sst_stacksize; ++i)
+	    {
+		put_bytes(fp, (long_u)bp[i].bs_idx, 4);
+		put_bytes(fp, (long_u)bp[i].bs_flags, 4);
+# ifdef FEAT_CONCEAL
+		put_bytes(fp, (long_u)bp[i].bs_seqnr, 4);
+		ok = put_bytes(fp, (long_u)bp[i].bs_cchar, 4) == OK;
+# else
+		put_bytes(fp, 0L, 4);
+		ok = put_bytes(fp, 0L, 4) == OK;
+# endif
+	    }
+	}
+	if (fclose(fp) != 0)
+	    ok = FALSE;
+	if (!ok)
+	    mch_remove(file_name);
+    }
+    if (!ok && p_verbose > 0)
+    {
+	verbose_enter();
+	smsg(_("Cannot write syntax cache file: %s"), file_name);
+	verbose_leave();
+    }
+    vim_free(file_name);
+}
+
+/*
+ * Read the syntax states for syn_buf from its syntax cache file into the
+ * empty b_sst_array[] of syn_block.  Only when the text and the syntax items
+ * are the same as when the file was written.
+ */
+    static void
+syn_cache_read(void)
+{
+    char_u	*file_name;
+    char_u	hash[UNDO_HASH_SIZE];
+    char_u	read_hash[UNDO_HASH_SIZE];
+    FILE	*fp;
+    synstate_T	*p;
+    synstate_T	*last = NULL;
+    bufstate_T	*bp;
+    linenr_T	lnum;
+    long	count;
+    int		next_idx;
+    int		stacksize;
+    int		ok = TRUE;
+    int		i;
+# ifdef UNIX
+    stat_T	st_orig;
+    stat_T	st_cache;
+# endif
+
+    if (!syn_cache_usable(syn_buf))
+	return;
+    file_name = u_get_syn_cache_name(syn_buf->b_ffname, TRUE);
+    if (file_name == NULL)
+	return;
+# ifdef UNIX
+    // For safety we only read a syntax cache file if the owner is equal to
+    // the owner of the text file or equal to the current user, like the
+    // undo file.
+    if (mch_stat((char *)syn_buf->b_ffname, &st_orig) >= 0
+	    && mch_stat((char *)file_name, &st_cache) >= 0
+	    && st_orig.st_uid != st_cache.st_uid
+	    && st_cache.st_uid != getuid())
+    {
+	if (p_verbose > 0)
+	{
+	    verbose_enter();
+	    smsg(_("Not reading syntax cache file, owner differs: %s"),
+								   file_name);
+	    verbose_leave();
+	}
+	vim_free(file_name);
+	return;
+    }
+# endif
+    fp = mch_fopen((char *)file_name, READBIN);
+    vim_free(file_name);
+    if (fp == NULL)
+	return;
+
+    if (!syn_cache_check_magic(fp))
+	goto theend;
+    syn_cache_def_hash(syn_block, syn_buf, hash);
+    if (fread(read_hash, UNDO_HASH_SIZE, 1, fp) != 1
+				|| memcmp(hash, read_hash, UNDO_HASH_SIZE) != 0)
+	goto theend;
+    if (fread(read_hash, UNDO_HASH_SIZE, 1, fp) != 1
+		|| memcmp(syn_buf->b_syn_cache_hash, read_hash,
+							UNDO_HASH_SIZE) != 0)
+	goto theend;
+
+    count = get4c(fp);
+    while (count-- > 0 && syn_block->b_sst_freecount > 0)
+    {
+	lnum = get4c(fp);
+	i = get4c(fp);
+	next_idx = get4c(fp);
+	stacksize = get4c(fp);
+	if (lnum <= (last == NULL ? 0 : last->sst_lnum)
+		|| lnum > syn_buf->b_ml.ml_line_count
+		|| next_idx < 0
+		|| next_idx > syn_block->b_syn_patterns.ga_len
+		|| stacksize < 0 || stacksize > 10000)
+	{
+	    ok = FALSE;
+	    break;
+	}
+
+	// Take the first item from the free list and append it to the used
+	// list.
+	p = syn_block->b_sst_firstfree;
+	syn_block->b_sst_firstfree = p->sst_next;
+	--syn_block->b_sst_freecount;
+	p->sst_next = NULL;
+	if (last == NULL)
+	    syn_block->b_sst_first = p;
+	else
+	    last->sst_next = p;
+	last = p;
+
+	p->sst_lnum = lnum;
+	p->sst_next_flags = i;
+	p->sst_next_list = next_idx == 0 ? NULL
+			    : SYN_ITEMS(syn_block)[next_idx - 1].sp_next_list;
+	p->sst_tick = display_tick;
+	p->sst_change_lnum = 0;
+	p->sst_stacksize = stacksize;
+	if (stacksize > SST_FIX_STATES)
+	{
+	    ga_init2(&p->sst_union.sst_ga, (int)sizeof(bufstate_T), 1);
+	    if (ga_grow(&p->sst_union.sst_ga, stacksize) == FAIL)
+	    {
+		p->sst_stacksize = 0;
+		ok = FALSE;
+		break;
+	    }
+	    p->sst_union.sst_ga.ga_len = stacksize;
+	    bp = SYN_STATE_P(&(p->sst_union.sst_ga));
+	}
+	else
+	    bp = p->sst_union.sst_stack;
+	for (i = 0; i < stacksize; ++i)
+	{
+	    bp[i].bs_idx = get4c(fp);
+	    bp[i].bs_flags = get4c(fp);
+# ifdef FEAT_CONCEAL
+	    bp[i].bs_seqnr = get4c(fp);
+	    bp[i].bs_cchar = get4c(fp);
+# else
+	    (void)get4c(fp);
+	    (void)get4c(fp);
+# endif
+	    bp[i].bs_extmatch = NULL;
+	    if (bp[i].bs_idx < 0
+		    || bp[i].bs_idx >= syn_block->b_syn_patterns.ga_len)
+		ok = FALSE;
+	}
+	if (!ok || feof(fp))
+	{
+	    ok = FALSE;
+	    break;
+	}
+    }
+
+    // Don't use anything from a corrupted file.
+    if (!ok)
+    {
+	syn_stack_free_block(syn_block);
+	syn_stack_alloc();
+    }
+
+theend:
+    fclose(fp);
+}
+#endif
+
 /*
  * We cannot simply discard growarrays full of state_items or buf_states; we
  * have to manually release their extmatch pointers first.
@@ -1055,6 +1615,7 @@ syn_stack_free_block(synblock_T *block)
 	block->b_sst_first = NULL;
 	block->b_sst_len = 0;
     }
+    block->b_sst_idle_lnum = 0;
 }
 /*
  * Free b_sst_array[] for buffer "buf".
@@ -1184,6 +1745,11 @@ syn_stack_apply_changes_block(synblock_T *block, buf_T *buf)
     synstate_T	*p, *prev, *np;
     linenr_T	n;
 
+    // States after the change need to be checked again while idle.
+    if (block->b_sst_idle_lnum != MAXLNUM
+				       && block->b_sst_idle_lnum > buf->b_mod_top)
+	block->b_sst_idle_lnum = buf->b_mod_top;
+
     prev = NULL;
     for (p = block->b_sst_first; p != NULL; )
     {
@@ -1223,6 +1789,17 @@ syn_stack_apply_changes_block(synblock_T *block, buf_T *buf)
     }
 }
 
+/*
+ * Return the distance between stored states for lines that are not displayed.
+ */
+    static int
+syn_stack_dist(synblock_T *block, buf_T *buf)
+{
+    if (block->b_sst_len <= Rows)
+	return 999999;
+    return buf->b_ml.ml_line_count / (block->b_sst_len - Rows) + 1;
+}
+
 /*
  * Reduce the number of entries in the state stack for syn_buf.
  * Returns TRUE if at least one entry was freed.
@@ -1240,10 +1817,7 @@ syn_stack_cleanup(void)
 	return retval;
 
     // Compute normal distance between non-displayed entries.
-    if (syn_block->b_sst_len <= Rows)
-	dist = 999999;
-    else
-	dist = syn_buf->b_ml.ml_line_count / (syn_block->b_sst_len - Rows) + 1;
+    dist = syn_stack_dist(syn_block, syn_buf);
 
     /*
      * Go through the list to find the "tick" for the oldest entry that can
@@ -1277,6 +1851,11 @@ syn_stack_cleanup(void)
     {
 	if (p->sst_tick == tick && prev->sst_lnum + dist > p->sst_lnum)
 	{
+	    // The next entry can't be validated before this one could.
+	    if (p->sst_next != NULL && p->sst_next->sst_change_lnum != 0
+		    && p->sst_next->sst_change_lnum < p->sst_change_lnum)
+		p->sst_next->sst_change_lnum = p->sst_change_lnum;
+
 	    // Move this entry from used list to free list
 	    prev->sst_next = p->sst_next;
 	    syn_stack_free_entry(syn_block, p);
@@ -1351,6 +1930,11 @@ store_current_state(void)
     {
 	if (sp != NULL)
 	{
+	    // The next entry can't be validated before this one could.
+	    if (sp->sst_next != NULL && sp->sst_next->sst_change_lnum != 0
+		    && sp->sst_next->sst_change_lnum < sp->sst_change_lnum)
+		sp->sst_next->sst_change_lnum = sp->sst_change_lnum;
+
 	    // find "sp" in the list and remove it
 	    if (syn_block->b_sst_first == sp)
 		// it's the first entry
@@ -1439,6 +2023,13 @@ store_current_state(void)
 	sp->sst_next_list = current_next_list;
 	sp->sst_tick = display_tick;
 	sp->sst_change_lnum = 0;
+
+	// A following state that still needs to be checked was not computed
+	// from this state, finding this state unchanged later does not make
+	// it valid.  Only checking the state at its own line does.
+	if (sp->sst_next != NULL && sp->sst_next->sst_change_lnum != 0
+			&& sp->sst_next->sst_change_lnum <= current_lnum)
+	    sp->sst_next->sst_change_lnum = current_lnum + 1;
     }
     current_state_stored = TRUE;
     return sp;
@@ -1874,12 +2465,12 @@ syn_current_attr(
 	    if (do_keywords)
 	    {
 	      line = syn_getcurline();
-	      if (vim_iswordp_buf(line + current_col, syn_buf)
+	      if (SYN_ISWORDP(line + current_col)
 		      && (current_col == 0
-			  || !vim_iswordp_buf(line + current_col - 1
+			  || !SYN_ISWORDP(line + current_col - 1
 			      - (has_mbyte
 				  ? (*mb_head_off)(line, line + current_col - 1)
-				  : 0) , syn_buf)))
+				  : 0))))
 	      {
 		syn_id = check_keyword_id(line, (int)current_col,
 					 &endcol, &flags, &next_list, cur_si,
@@ -3128,7 +3719,7 @@ syn_add_start_off(
     {
 	// a "\n" at the end of the pattern may take us below the last line
 	result->lnum = syn_buf->b_ml.ml_line_count;
-	col = (int)STRLEN(ml_get_buf(syn_buf, result->lnum, FALSE));
+	col = ml_get_buf_len(syn_buf, result->lnum);
     }
     if (off != 0)
     {
@@ -3208,7 +3799,9 @@ syn_regexec(
     }
 #endif
 #ifdef FEAT_RELTIME
-    if (timed_out && !syn_win->w_s->b_syn_slow)
+    if (timed_out && syn_idle)
+	syn_idle_timed_out = TRUE;
+    else if (timed_out && !syn_win->w_s->b_syn_slow)
     {
 	syn_win->w_s->b_syn_slow = TRUE;
 	msg(_("'redrawtime' exceeded, syntax highlighting disabled"));
@@ -3243,6 +3836,8 @@ check_keyword_id(
     char_u	*kwp;
     int		round;
     int		kwlen;
+    int		non_ascii = FALSE;
+    unsigned	*lens;
     char_u	keyword[MAXKEYWLEN + 1]; // assume max. keyword len is 80
     hashtab_T	*ht;
     hashitem_T	*hi;
@@ -3253,16 +3848,32 @@ check_keyword_id(
     kwlen = 0;
     do
     {
-	if (has_mbyte)
-	    kwlen += (*mb_ptr2len)(kwp + kwlen);
-	else
+	if (kwp[kwlen] < 0x80)
 	    ++kwlen;
+	else
+	{
+	    non_ascii = TRUE;
+	    if (has_mbyte)
+		kwlen += (*mb_ptr2len)(kwp + kwlen);
+	    else
+		++kwlen;
+	}
     }
-    while (vim_iswordp_buf(kwp + kwlen, syn_buf));
+    while (SYN_ISWORDP(kwp + kwlen));
 
     if (kwlen > MAXKEYWLEN)
 	return 0;
 
+    // Most words are not a keyword, quickly skip a word when there is no
+    // keyword with the same first byte and length.  Not when ignoring case
+    // and the word is not ASCII, folding may change the number of bytes.
+    if (!non_ascii || syn_block->b_keywtab_ic.ht_used == 0)
+    {
+	lens = syn_keyword_lens();
+	if (lens != NULL && (lens[*kwp] & KEYWLEN_BIT(kwlen)) == 0)
+	    return 0;
+    }
+
     /*
      * Must make a copy of the keyword, so we can add a NUL and make it
      * lowercase.
@@ -3313,6 +3924,61 @@ check_keyword_id(
     return 0;
 }
 
+/*
+ * Return the table of keyword lengths for syn_block, indexed by the first
+ * byte of the keyword, with KEYWLEN_BIT() set for each length.  For keywords
+ * that ignore case the entries for both the upper and lower case first byte
+ * are set.  Such a keyword with a non-ASCII character can only match a
+ * non-ASCII word, the table is not used for those.
+ * The table is computed when first needed after the keywords changed.
+ * Returns NULL when out of memory.
+ */
+    static unsigned *
+syn_keyword_lens(void)
+{
+    unsigned	*lens;
+    hashtab_T	*ht;
+    hashitem_T	*hi;
+    keyentry_T	*kp;
+    char_u	*p;
+    int		todo;
+    int		round;
+    int		c;
+
+    if (syn_block->b_keywlens != NULL)
+	return syn_block->b_keywlens;
+    lens = ALLOC_CLEAR_MULT(unsigned, 256);
+    if (lens == NULL)
+	return NULL;
+
+    for (round = 1; round <= 2; ++round)
+    {
+	ht = round == 1 ? &syn_block->b_keywtab : &syn_block->b_keywtab_ic;
+	todo = (int)ht->ht_used;
+	for (hi = ht->ht_array; todo > 0; ++hi)
+	    if (!HASHITEM_EMPTY(hi))
+	    {
+		--todo;
+		// All entries in the list have the same keyword.
+		kp = HI2KE(hi);
+		c = kp->keyword[0];
+		if (round == 1)
+		    lens[c] |= KEYWLEN_BIT(STRLEN(kp->keyword));
+		else
+		{
+		    for (p = kp->keyword; *p != NUL && *p < 0x80; ++p)
+			;
+		    if (*p != NUL)
+			continue;
+		    lens[TOLOWER_ASC(c)] |= KEYWLEN_BIT(p - kp->keyword);
+		    lens[TOUPPER_ASC(c)] |= KEYWLEN_BIT(p - kp->keyword);
+		}
+	    }
+    }
+    syn_block->b_keywlens = lens;
+    return lens;
+}
+
 /*
  * Handle ":syntax conceal" command.
  */
@@ -3528,6 +4194,7 @@ syntax_clear(synblock_T *block)
     // free the keywords
     clear_keywtab(&block->b_keywtab);
     clear_keywtab(&block->b_keywtab_ic);
+    VIM_CLEAR(block->b_keywlens);
 
     // free the syntax patterns
     for (i = block->b_syn_patterns.ga_len; --i >= 0; )
@@ -3750,6 +4417,7 @@ syn_clear_one(int id, int syncing)
     {
 	(void)syn_clear_keyword(id, &curwin->w_s->b_keywtab);
 	(void)syn_clear_keyword(id, &curwin->w_s->b_keywtab_ic);
+	VIM_CLEAR(curwin->w_s->b_keywlens);
     }
 
     // clear the patterns for "id"
@@ -4465,6 +5133,7 @@ add_keyword(
 	ht = &curwin->w_s->b_keywtab_ic;
     else
 	ht = &curwin->w_s->b_keywtab;
+    VIM_CLEAR(curwin->w_s->b_keywlens);
 
     hash = hash_hash(kp->keyword);
     hi = hash_lookup(ht, kp->keyword, hash);
@@ -50,7 +50,13 @@ TEST_VIM9_RES = \
 	test_vim9_script.res
 
 # Benchmark scripts.
-SCRIPTS_BENCH = test_bench_regexp.res
+SCRIPTS_BENCH = \
+	test_bench_readfile.res \
+	test_bench_regexp.res \
+	test_bench_swapsync.res \
+	test_bench_syntax.res \
+	test_bench_vim9.res \
+	test_bench_writefile.res
 
 # Individual tests, including the ones part of test_alot.
 # Please keep sorted up to test_alot.
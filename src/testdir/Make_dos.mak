@@ -139,7 +139,7 @@ test_gui_init.res: test_gui_init.vim
 opt_test.vim: ../optiondefs.h gen_opt_test.vim
 	$(VIMPROG) -u NONE -S gen_opt_test.vim --noplugin --not-a-term ../optiondefs.h
 
-test_bench_regexp.res: test_bench_regexp.vim
+$(SCRIPTS_BENCH):
 	-if exist benchmark.out del benchmark.out
 	@echo $(VIMPROG) > vimcmd
 	$(VIMPROG) -u NONE $(NO_INITS) -S runtest.vim $*.vim
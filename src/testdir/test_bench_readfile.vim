@@ -0,0 +1,39 @@
+" Test for benchmarking reading a large file into a buffer
+
+source check.vim
+CheckFeature reltime
+CheckFeature float
+
+func Measure(fileformat)
+  let line = 'a line of text for the benchmark, 1234567890,abcdefghijklmnop'
+  let lines = repeat([line], 1000000)
+  call writefile(lines, 'Xbench_readfile')
+  if a:fileformat == 'dos'
+    " writefile() only writes NL, use Vim itself to write CR-NL
+    exe 'noswapfile edit Xbench_readfile'
+    set fileformat=dos
+    write
+    bwipe!
+  endif
+  let size = getfsize('Xbench_readfile')
+
+  for i in range(3)
+    let start = reltime()
+    exe 'noswapfile edit Xbench_readfile'
+    let elapsed = reltimefloat(reltime(start))
+    call assert_equal(1000000, line('$'))
+    call assert_equal(a:fileformat, &fileformat)
+    bwipe!
+    let s = printf('file: %d bytes, ff: %s, time: %.3f sec, %.1f Mbyte/sec',
+          \ size, a:fileformat, elapsed, size / elapsed / 1000000)
+    call writefile([s], 'benchmark.out', "a")
+  endfor
+  call delete('Xbench_readfile')
+endfunc
+
+func Test_Readfile_Benchmark()
+  call Measure('unix')
+  call Measure('dos')
+endfunc
+
+" vim: shiftwidth=2 sts=2 expandtab
@@ -21,4 +21,102 @@ func Test_Regex_Benchmark()
   call Measure('samples/re.freeze.txt', '\s\+\%#\@<!$', '+5')
 endfunc
 
+" Patterns as typed for a search or used in scripts.
+let s:search_patterns = [
+      \ 'return',
+      \ '\<if\>',
+      \ '\cfixme\|todo\|xxx',
+      \ '\s\+$',
+      \ '^\s*#\s*if\%(def\|ndef\)\=\>',
+      \ '\<\h\w*\s*(',
+      \ '\<0x\x\+\>\|\<\d\+\%(\.\d*\)\=\>',
+      \ '"\%([^"\\]\|\\.\)*"',
+      \ '/\*\_.\{-}\*/',
+      \ '\<\%(int\|char\|long\|void\)\>\s\+\*\=\w\+',
+      \ '[[:upper:]][[:lower:]]\+[[:upper:]]\w*',
+      \ '\%(\w\+\.\)\+\w\+@\w\+',
+      \ 'https\=://[^ \t>)]\+',
+      \ '\(\<\w\+\>\)\s\+\1\>',
+      \ '\w\+\ze\s*=[^=]',
+      \ '\%(^\|[^\\]\)\@<=|\w\+|',
+      \ ]
+
+" Files used as text to match against and their syntax.
+let s:text_files = [
+      \ ['../eval.c', 'c'], ['../syntax.c', 'c'], ['../regexp_nfa.c', 'c'],
+      \ ['../../runtime/doc/eval.txt', 'help'],
+      \ ['../../runtime/doc/options.txt', 'help'],
+      \ ['../../runtime/autoload/netrw.vim', 'vim'],
+      \ ]
+
+" Run "after" in a Vim with 'regexpengine' set to "re", return what it wrote
+" in "g:result".
+func s:RunCorpus(re, after)
+  let after = a:after + ['call writefile(g:result, "Xresult")', 'qall!']
+  call RunVim(['set re=' .. a:re], after, '')
+  let result = filereadable('Xresult') ? readfile('Xresult') : []
+  call delete('Xresult')
+  return result
+endfunc
+
+" Count all matches of each search pattern in a large file, with both
+" engines.
+func Test_Regex_Corpus_Benchmark()
+  let lines = []
+  for [fname, _] in s:text_files
+    call extend(lines, readfile(fname))
+  endfor
+  call writefile(lines, 'Xbench_re_text')
+  call writefile(s:search_patterns, 'Xbench_re_pats')
+
+  let after =<< trim [CODE]
+    edit Xbench_re_text
+    let g:result = []
+    for pat in readfile('Xbench_re_pats')
+      let start = reltime()
+      exe 'silent! %s#' .. pat .. '##gne'
+      call add(g:result, reltimestr(reltime(start)))
+    endfor
+  [CODE]
+  let times = {}
+  for re in [1, 2]
+    let times[re] = s:RunCorpus(re, after)
+  endfor
+  for idx in range(len(s:search_patterns))
+    let s = 'pattern: ' .. s:search_patterns[idx]
+    for re in [1, 2]
+      let s ..= ', re: ' .. re .. ', time: ' .. get(times[re], idx, '-')
+    endfor
+    call writefile([s], 'benchmark.out', "a")
+  endfor
+
+  call delete('Xbench_re_text')
+  call delete('Xbench_re_pats')
+endfunc
+
+" Highlight files with the syntax files in runtime/syntax, synced from the
+" start, with both engines.
+func Test_Regex_Syntax_Benchmark()
+  CheckFeature syntax
+
+  let highlight =<< trim [CODE]
+    syntax sync fromstart
+    let start = reltime()
+    for lnum in range(1, line('$'))
+      call synID(lnum, 1, 0)
+    endfor
+    let g:result = [reltimestr(reltime(start))]
+  [CODE]
+  for [fname, syntax] in s:text_files
+    let after = ['syntax enable', 'edit ' .. fname,
+          \ 'setlocal syntax=' .. syntax] + highlight
+    let s = 'file: ' .. fname .. ', syntax: ' .. syntax
+    for re in [1, 2]
+      let time = get(s:RunCorpus(re, after), 0, '-')
+      let s ..= ', re: ' .. re .. ', time: ' .. time
+    endfor
+    call writefile([s], 'benchmark.out', "a")
+  endfor
+endfunc
+
 " vim: shiftwidth=2 sts=2 expandtab
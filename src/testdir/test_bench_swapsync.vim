@@ -0,0 +1,59 @@
+" Test for benchmarking the delay caused by syncing the swap file while typing
+
+source check.vim
+CheckFeature reltime
+CheckFeature float
+
+func s:CharTyped()
+  call add(s:times, reltime())
+endfunc
+
+func Measure(swapsync)
+  let save_uc = &updatecount
+  let save_sws = &swapsync
+  let save_dir = &directory
+  set updatecount=20 directory=.
+  let &swapsync = a:swapsync
+
+  call writefile(repeat(['some text in a line'], 20000), 'Xbench_swapsync')
+  edit Xbench_swapsync
+  call assert_notequal('', swapname(''))
+  let s:times = []
+  augroup BenchSwapsync
+    au InsertCharPre * call s:CharTyped()
+  augroup END
+
+  " Type text in several places, so that several blocks are dirty.
+  let keys = ''
+  for lnum in range(1, 20000, 500)
+    let keys ..= lnum .. 'GA' .. repeat('x', 50) .. "\<Esc>"
+  endfor
+  call feedkeys(keys, 'xt')
+
+  au! BenchSwapsync
+  augroup! BenchSwapsync
+  bwipe!
+  call delete('Xbench_swapsync')
+  let &updatecount = save_uc
+  let &swapsync = save_sws
+  let &directory = save_dir
+
+  " Time between two typed characters, in msec.
+  let delays = []
+  for i in range(1, len(s:times) - 1)
+    call add(delays, reltimefloat(reltime(s:times[i - 1], s:times[i])) * 1000)
+  endfor
+  call sort(delays, 'f')
+  let n = len(delays)
+  let s = printf('swapsync: %s, chars: %d, p50: %.3f, p90: %.3f, p99: %.3f, max: %.3f msec',
+        \ a:swapsync, n + 1, delays[n / 2], delays[n * 9 / 10],
+        \ delays[n * 99 / 100], delays[n - 1])
+  call writefile([s], 'benchmark.out', "a")
+endfunc
+
+func Test_Swapsync_Benchmark()
+  call Measure('fsync')
+  call Measure('')
+endfunc
+
+" vim: shiftwidth=2 sts=2 expandtab
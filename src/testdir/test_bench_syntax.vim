@@ -0,0 +1,73 @@
+" Test for benchmarking jumping around in a big file with syntax highlighting
+" that is synced from the start
+
+source check.vim
+source shared.vim
+CheckFeature reltime
+CheckFeature float
+CheckFeature timers
+CheckFeature syntax
+
+" Jump to lines all over the file and redraw, after waiting "wait" msec for
+" the user to type something.
+func Measure(wait)
+  let after =<< trim [CODE]
+    edit Xbench_syntax.c
+    syn region cComment start=+/\*+ end=+\*/+
+    syn region cString start=+"+ skip=+\\"+ end=+"+
+    syn keyword cStatement if while return int
+    syn match cNumber /\<\d\+\>/
+    syn match cLineComment +//.*+
+    syn sync fromstart
+    hi link cComment Comment
+    hi link cString String
+    hi link cStatement Statement
+    hi link cNumber Number
+    hi link cLineComment Comment
+    redraw
+
+    func Jump(timer)
+      let times = []
+      for lnum in range(10000, line('$'), 10000)
+        let start = reltime()
+        exe lnum
+        redraw
+        call add(times, reltimefloat(reltime(start)) * 1000)
+      endfor
+      call sort(times, 'f')
+      let total = 0.0
+      for t in times
+        let total += t
+      endfor
+      call writefile([printf('%.3f %.3f', total, times[-1])], 'Xresult')
+      qall!
+    endfunc
+  [CODE]
+  call add(after, 'call timer_start(' .. a:wait .. ', "Jump")')
+
+  if RunVim([], after, '')
+    let [total, max] = split(readfile('Xresult')[0])
+    let s = printf('wait: %d msec, jump total: %s msec, max: %s msec',
+          \ a:wait, total, max)
+    call writefile([s], 'benchmark.out', "a")
+  endif
+  call delete('Xresult')
+endfunc
+
+func Test_Syntax_Benchmark()
+  let lines = []
+  for i in range(20000)
+    call extend(lines, ['/* comment ' .. i, ' * more text 123 */',
+          \ 'if (x == 42) { while (y) z(); }',
+          \ '"a string with /* no comment */"', 'int a = 99;',
+          \ 'call(1, 2, 3);', '// line comment', 'return 0;', '', '}'])
+  endfor
+  call writefile(lines, 'Xbench_syntax.c')
+
+  call Measure(0)
+  call Measure(2000)
+
+  call delete('Xbench_syntax.c')
+endfunc
+
+" vim: shiftwidth=2 sts=2 expandtab
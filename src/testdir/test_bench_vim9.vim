@@ -0,0 +1,166 @@
+" Test for benchmarking the Vim9 interpreter: run loops in :def functions and
+" report the number of instructions executed per second
+
+source check.vim
+CheckFeature reltime
+CheckFeature float
+
+def s:WhileSum(n: number): number
+  var total = 0
+  var i = 0
+  while i < n
+    total = total + i
+    i += 1
+  endwhile
+  return total
+enddef
+
+def s:WhilePoly(n: number): number
+  var total = 0
+  var i = 0
+  while i < n
+    total = (total + i * i * 3 - i / 2) % 1000003
+    i += 1
+  endwhile
+  return total
+enddef
+
+def s:WhileFloat(n: number): float
+  var x = 0.0
+  var f = 0.0
+  var limit = 0.0 + n
+  while f < limit
+    x = x * 0.999 + f / 3.0
+    f = f + 1.0
+  endwhile
+  return x
+enddef
+
+def s:WhileBool(n: number): number
+  var count = 0
+  var i = 0
+  while i < n
+    var even = i % 2 == 0
+    if even
+      count += 1
+    endif
+    i += 1
+  endwhile
+  return count
+enddef
+
+def s:ForModulo(n: number): number
+  var total = 0
+  for i in range(n)
+    total += i % 7
+  endfor
+  return total
+enddef
+
+def s:Add(a: number, b: number): number
+  return a + b
+enddef
+
+def s:WhileCall(n: number): number
+  var total = 0
+  var i = 0
+  while i < n
+    total = s:Add(total, i)
+    i += 1
+  endwhile
+  return total
+enddef
+
+func s:LegacyAdd(a, b)
+  return a:a + a:b
+endfunc
+
+" A legacy function is looked up by name when called
+def s:WhileLegacyCall(n: number): number
+  var total = 0
+  var i = 0
+  while i < n
+    total = s:LegacyAdd(total, i)
+    i += 1
+  endwhile
+  return total
+enddef
+
+def s:WhileFuncref(n: number): number
+  var Ref: func = function('s:LegacyAdd')
+  var total = 0
+  var i = 0
+  while i < n
+    total = Ref(total, i)
+    i += 1
+  endwhile
+  return total
+enddef
+
+def s:ForString(n: number): number
+  var s = ''
+  for i in range(n)
+    s ..= 'x'
+  endfor
+  return len(s)
+enddef
+
+def s:ForConcat(n: number): number
+  var total = 0
+  var name = 'name'
+  for i in range(n)
+    var s = 'item ' .. i .. ': ' .. name .. '!'
+    total += len(s)
+  endfor
+  return total
+enddef
+
+def s:ForList(n: number): number
+  var l: list<number> = []
+  for i in range(n)
+    l->add(i * 2)
+  endfor
+  return len(l)
+enddef
+
+" Return the number of instructions in the loop of function "name", from the
+" start of the loop up to and including the jump back to it.
+func s:LoopSize(name)
+  let lines = split(execute('disassemble ' .. a:name), "\n")
+  for line in lines
+    let m = matchlist(line, '^\s*\(\d\+\) JUMP -> \(\d\+\)$')
+    if !empty(m) && str2nr(m[2]) < str2nr(m[1])
+      return str2nr(m[1]) - str2nr(m[2]) + 1
+    endif
+  endfor
+  return 0
+endfunc
+
+func s:Measure(name, n)
+  let Func = function(a:name)
+  call Func(10)
+  let start = reltime()
+  call Func(a:n)
+  let time = reltimefloat(reltime(start))
+  let size = s:LoopSize(a:name)
+  let s = printf('%s: %d loops of %d instructions, time: %.3f sec, '
+        \ .. 'instructions/sec: %.0f',
+        \ a:name, a:n, size, time, a:n * size / time)
+  call writefile([s], 'benchmark.out', "a")
+endfunc
+
+func Test_Vim9_Benchmark()
+  call s:Measure('s:WhileSum', 2000000)
+  call s:Measure('s:WhilePoly', 2000000)
+  call s:Measure('s:WhileFloat', 2000000)
+  call s:Measure('s:WhileBool', 2000000)
+  call s:Measure('s:ForModulo', 2000000)
+  call s:Measure('s:WhileCall', 500000)
+  call s:Measure('s:WhileLegacyCall', 200000)
+  call s:Measure('s:WhileFuncref', 200000)
+  call s:Measure('s:ForString', 100000)
+  call s:Measure('s:ForConcat', 500000)
+  call s:Measure('s:ForList', 500000)
+endfunc
+
+" vim: shiftwidth=2 sts=2 expandtab
@@ -0,0 +1,35 @@
+" Test for benchmarking writing a large buffer to a file
+
+source check.vim
+CheckFeature reltime
+CheckFeature float
+
+func Measure(fileformat, fileencoding)
+  new
+  let line = 'a line of text for the benchmark, 1234567890,abcdefghijklmnop'
+  call setline(1, repeat([line], 1000000))
+  let &fileformat = a:fileformat
+  let &fileencoding = a:fileencoding
+
+  for i in range(3)
+    let start = reltime()
+    exe 'noswapfile write! Xbench_writefile'
+    let elapsed = reltimefloat(reltime(start))
+    let size = getfsize('Xbench_writefile')
+    let s = printf('file: %d bytes, ff: %s, fenc: %s, time: %.3f sec, %.1f Mbyte/sec',
+          \ size, a:fileformat, a:fileencoding, elapsed,
+          \ size / elapsed / 1000000)
+    call writefile([s], 'benchmark.out', "a")
+  endfor
+  bwipe!
+  call delete('Xbench_writefile')
+endfunc
+
+func Test_Writefile_Benchmark()
+  call Measure('unix', '')
+  call Measure('dos', '')
+  call Measure('unix', 'latin1')
+  call Measure('unix', 'utf-16')
+endfunc
+
+" vim: shiftwidth=2 sts=2 expandtab
@@ -170,4 +170,21 @@ func Test_getbufinfo_lines()
   bw!
 endfunc
 
+func Test_getbufinfo_memfile()
+  new
+  call setline(1, range(1, 1000))
+  let info = getbufinfo(bufnr())[0].memfile
+  call assert_equal(['blocks', 'evictions', 'hits', 'misses'], sort(keys(info)))
+  call assert_true(info.blocks > 0)
+  call assert_true(info.hits > 0)
+  call assert_true(info.misses >= 0)
+  call assert_true(info.evictions >= 0)
+  bwipe!
+
+  " a buffer that is not loaded has no memfile
+  badd Xnotloaded
+  call assert_false(has_key(getbufinfo('Xnotloaded')[0], 'memfile'))
+  bwipe Xnotloaded
+endfunc
+
 " vim: shiftwidth=2 sts=2 expandtab
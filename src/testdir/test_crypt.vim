@@ -197,6 +197,28 @@ func Test_uncrypt_xchacha20_3_persistent_undo()
   call delete('Xcrypt_sodium_undo.txt')
 endfunc
 
+" The text is encrypted in blocks of 8192 bytes, the last block is marked.
+" Check that it is done once when the last line or its EOL fills a block.
+func Test_uncrypt_xchacha20_block_end()
+  CheckFeature sodium
+  set cryptmethod=xchacha20
+  for [len, eol] in [[8192, 1], [8191, 1], [8192, 0]]
+    sp Xcrypt_sodium_end.txt
+    let &l:eol = eol
+    let &l:fixeol = eol
+    call setline(1, repeat('x', len))
+    call feedkeys(":X\<CR>sodium\<CR>sodium\<CR>", 'xt')
+    w!
+    bw!
+    call feedkeys(":sp Xcrypt_sodium_end.txt\<CR>sodium\<CR>", 'xt')
+    call assert_equal([repeat('x', len)], getline(1, '$'))
+    call assert_equal(eol, &eol)
+    bw!
+    call delete('Xcrypt_sodium_end.txt')
+  endfor
+  set cryptmethod&vim
+endfunc
+
 func Test_encrypt_xchacha20_missing()
   if has("sodium")
     return
@@ -1117,6 +1117,37 @@ func Test_byte2line_line2byte()
   bw!
 endfunc
 
+func Test_byte2line_line2byte_many_lines()
+  new
+  call setline(1, map(range(1, 5000), 'repeat("x", v:val % 17)'))
+  " Delete, insert and change lines in many places, so that the chunks used
+  " for the byte offsets are split and joined.
+  for lnum in range(4000, 100, -150)
+    exe lnum .. ',' .. (lnum + 40) .. 'delete'
+    call append(lnum / 2, repeat(['yy'], 60))
+    call setline(lnum / 3, 'changed line ' .. lnum)
+  endfor
+  normal! 1000GdGu
+
+  for ff in ['unix', 'dos']
+    let &fileformat = ff
+    let eol = ff == 'dos' ? 2 : 1
+    let offsets = []
+    let off = 1
+    for line in getline(1, '$')
+      call add(offsets, off)
+      let off += len(line) + eol
+    endfor
+    call assert_equal(offsets, map(range(1, line('$')), 'line2byte(v:val)'))
+    call assert_equal(range(1, line('$')),
+          \ map(copy(offsets), 'byte2line(v:val)'))
+    call assert_equal(off, line2byte(line('$') + 1))
+  endfor
+
+  set fileformat&
+  bw!
+endfunc
+
 " Test for byteidx() and byteidxcomp() functions
 func Test_byteidx()
   let a = '.é.' " one char of two bytes
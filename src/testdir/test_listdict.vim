@@ -1009,6 +1009,80 @@ func Test_deep_nested_dict()
   unlet deep_dict
 endfunc
 
+func s:MakeCycles(count)
+  for i in range(a:count)
+    let d = {'nr': i}
+    let d.list = [d, [d]]
+  endfor
+endfunc
+
+" Test for collecting only the lists and dicts created since the last garbage
+" collection
+func Test_garbagecollect_young()
+  call test_garbagecollect_now()
+  let g:gc_old = {}
+  call test_garbagecollect_now()
+  let before = garbagecollect_info()
+
+  call s:MakeCycles(100)
+  let kept = {'nr': 1}
+  let kept.self = kept
+  let kept.list = [kept, {}]
+  let l = [1]
+  call add(l, l)
+  let g:gc_old.young = l
+  unlet l
+
+  call test_garbagecollect_now(1)
+  let info = garbagecollect_info()
+  call assert_equal(before.young + 1, info.young)
+  call assert_equal(before.full, info.full)
+  call assert_equal(before.young_freed + 300, info.young_freed)
+  call assert_equal(1, kept.self.list[0].nr)
+  call assert_equal({}, kept.list[1])
+  call assert_equal(1, g:gc_old.young[1][1][0])
+  call assert_true(info.promoted > 0)
+
+  " what survived is not checked again
+  unlet kept
+  call test_garbagecollect_now(1)
+  call assert_equal(info.young_freed, garbagecollect_info().young_freed)
+
+  call test_garbagecollect_now()
+  let info = garbagecollect_info()
+  call assert_equal(before.full + 1, info.full)
+  call assert_true(info.full_freed >= before.full_freed + 3)
+  call assert_equal(0, info.promoted)
+  if has('reltime') && has('float')
+    call assert_equal(v:t_float, type(info.full_time))
+    call assert_true(info.max_time >= 0.0)
+  endif
+  unlet g:gc_old
+endfunc
+
+" Marking lists and dicts for deepcopy() or :echo does not hide the garbage
+" created before them from a young collection
+func Test_garbagecollect_young_copyID()
+  call test_garbagecollect_now()
+  let g:gc_old = {'list': [[1]]}
+  call test_garbagecollect_now()
+  let before = garbagecollect_info()
+
+  for round in range(3)
+    call s:MakeCycles(100)
+    let g:gc_young = [[round]]
+    let g:gc_copy = deepcopy(g:gc_young)
+    echo g:gc_young g:gc_old
+    call test_garbagecollect_now(1)
+  endfor
+  let info = garbagecollect_info()
+  call assert_equal(before.young + 3, info.young)
+  call assert_equal(before.young_freed + 900, info.young_freed)
+  call assert_equal([[2]], g:gc_copy)
+  call assert_equal({'list': [[1]]}, g:gc_old)
+  unlet g:gc_old g:gc_young g:gc_copy
+endfunc
+
 " List and dict indexing tests
 func Test_listdict_index()
   call assert_fails('echo function("min")[0]', 'E695:')
@@ -5554,4 +5554,88 @@ func Test_vimgrep_fuzzy_match()
   call delete('Xfile2')
 endfunc
 
+" Files without a match are skipped without loading them when there are no
+" autocommands.  The result must be the same as when they are loaded.
+func Test_vimgrep_skip_files_without_match()
+  call writefile(['one two', 'two', 'three two'], 'Xvgr1')
+  call writefile(['four', 'five'], 'Xvgr2')
+  call writefile(["six\r", "two\r"], 'Xvgr3')
+  call writefile([], 'Xvgr4')
+  call writefile(["caf\xe9 two"], 'Xvgr5')
+  call writefile(["\xef\xbb\xbfseven"], 'Xvgr6')
+  call writefile(['eight', 'twelve'], 'Xvgr7')
+  " The test runner's SwapExists autocommand would make it load all files.
+  au! SwapExists
+
+  func s:GrepResult(cmd)
+    call setqflist([], 'f')
+    silent! exe a:cmd .. ' Xvgr*'
+    return getqflist()->map({_, v -> [bufname(v.bufnr), v.lnum, v.col,
+          \ v.text]})
+  endfunc
+  let cmds = ['vimgrep /two/', 'vimgrep /two/g', '2vimgrep /two/g',
+        \ 'vimgrep /^$/', 'vimgrep /caf./', 'vimgrep /^seven/',
+        \ 'vimgrep /\%2ltw/', 'vimgrep /\v%2ltw/', 'vimgrep /\<tw/',
+        \ 'vimgrep /six$/', 'vimgrep /ev\|ou/j', 'vimgrep /tw/fj',
+        \ 'vimgrep /nothing/']
+  let expected = []
+  augroup VgrTest
+    au BufReadPre * let g:vgr_loaded = 1
+  augroup END
+  for cmd in cmds
+    call add(expected, s:GrepResult(cmd))
+  endfor
+  au! VgrTest
+  augroup! VgrTest
+  for i in range(len(cmds))
+    call assert_equal(expected[i], s:GrepResult(cmds[i]), cmds[i])
+  endfor
+
+  " 'iskeyword' of the current buffer must not be used
+  new
+  setlocal isk+=#
+  call writefile(['#two'], 'Xvgr8')
+  call assert_fails('vimgrep /\<#tw/ Xvgr8', 'E480:')
+  bwipe!
+  call assert_equal([['Xvgr1', 1, 5, 'one two']], expected[0][:0])
+
+  delfunc s:GrepResult
+  unlet g:vgr_loaded
+  %bwipe!
+  for i in range(1, 8)
+    call delete('Xvgr' .. i)
+  endfor
+endfunc
+
+" Filetype detection does not stop :vimgrep from skipping files without
+" loading them, a 'fileformats' value without "unix" and "dos" does.
+func Test_vimgrep_skip_files_filetype()
+  call writefile(['# one', 'two'], 'Xvgrft1.c')
+  call writefile(['# three'], 'Xvgrft2.sh')
+  au! SwapExists
+  filetype on
+  let g:vgr_reads = 0
+  au filetypedetect BufRead Xvgrft* let g:vgr_reads += 1
+
+  call assert_fails('vimgrep /nothing/ Xvgrft*', 'E480:')
+  call assert_equal(0, g:vgr_reads)
+  vimgrep /two/ Xvgrft*
+  call assert_equal(1, g:vgr_reads)
+  call assert_equal([2], getqflist()->map({_, v -> v.lnum}))
+  call assert_equal('c', &filetype)
+  %bwipe!
+
+  set fileformats=mac
+  let g:vgr_reads = 0
+  call assert_fails('vimgrep /nothing/ Xvgrft*', 'E480:')
+  call assert_equal(2, g:vgr_reads)
+
+  set fileformats&
+  filetype off
+  unlet g:vgr_reads
+  call setqflist([], 'f')
+  call delete('Xvgrft1.c')
+  call delete('Xvgrft2.sh')
+endfunc
+
 " vim: shiftwidth=2 sts=2 expandtab
@@ -96,7 +96,8 @@ endfunc
 
 func Test_out_of_memory()
   new
-  s/^/,n
+  " Without the ";" it is quickly found that there can't be a match.
+  s/^/,n;/
   " This will be slow...
   call assert_fails('call search("\\v((n||<)+);")', 'E363:')
 endfunc
@@ -947,4 +948,102 @@ func Test_regexp_last_subst_string()
   close!
 endfunc
 
+" Test that compiled patterns are cached, but not when they depend on state
+" that is not part of the pattern.
+func Test_regexp_cache()
+  let hits = test_getvalue('regcache_hits')
+  for i in range(10)
+    call assert_equal('xbc', substitute('abc', '^a', 'x', ''))
+  endfor
+  call assert_inrange(hits + 9, hits + 10, test_getvalue('regcache_hits'))
+
+  new
+  call setline(1, ['abc', 'def', 'a.c'])
+  set nomagic
+  call assert_fails('1s/a.c/X/', 'E486:')
+  set magic
+  1s/a.c/X/
+  call assert_equal('X', getline(1))
+  call setline(4, 't')
+  set cpo+=l
+  call assert_equal(4, search('[\t]', 'w'))
+  set cpo-=l
+  call assert_equal(0, search('[\t]', 'w'))
+
+  " "~" uses the previous substitute string
+  2s/e/Y/
+  call assert_true('dYf' =~ '~')
+  call assert_false('aZc' =~ '~')
+  2s/Y/Z/
+  call assert_true('aZc' =~ '~')
+
+  " "[:keyword:]" uses 'iskeyword'
+  setlocal iskeyword=@
+  call assert_equal('', matchstr('-', '\%#=1[[:keyword:]]'))
+  setlocal iskeyword+=-
+  call assert_equal('-', matchstr('-', '\%#=1[[:keyword:]]'))
+  bwipe!
+endfunc
+
+" A line is skipped when a string that a match must include does not appear
+func Test_regexp_must_appear()
+  new
+  call setline(1, ['one_x', 'two', 'one_zz', 'a', 'ONE_ZZ', 'x', 'b y'])
+  for engine in [1, 2]
+    let re = '\%#=' .. engine
+    call assert_equal(3, search(re .. '\w\+_zz', 'cnw'), engine)
+    call assert_equal(5, search(re .. '\w\+_ZZ', 'cnw'), engine)
+    call assert_equal(3, search(re .. '\c\w\+_ZZ', 'cnw'), engine)
+    call assert_equal(0, search(re .. '\w\+_zzz', 'cnw'), engine)
+    call assert_equal(2, search(re .. '[a-z]*wo\|_q', 'cnw'), engine)
+    " text after a line break is in the next line
+    call assert_equal(5, search(re .. '\w\+_ZZ\nx', 'cnw'), engine)
+    call assert_equal(6, search(re .. '[a-z]\+\_s*b y', 'cnw'), engine)
+    call assert_equal(0, search(re .. '[a-z]\+\_s*b z', 'cnw'), engine)
+    call assert_equal(1, search(re .. '\(on\)\+e_x', 'cnw'), engine)
+  endfor
+  bwipe!
+endfunc
+
+func Test_regexptime()
+  CheckFeature profile
+
+  new
+  call setline(1, ['one 12', 'two 345', 'three'])
+  regexptime clear
+  regexptime on
+  call search('t\w\+')
+  %s/\d\+/N/g
+  call assert_equal('ee', matchstr('three', 'e\+'))
+  call matchadd('Search', 'tw[aeiou]')
+  redraw
+  " NFA gives up on a large count and the backtracking engine is used
+  call search('\%#=0o\{1,600}')
+  let a = execute('regexptime report')
+  call assert_match('^  TOTAL *COUNT *MATCH *SLOWEST *COMPILE *COMPILED *SWITCHED *PATTERN', a)
+  call assert_match('\n *\d*\.\d* \+[1-9] \+1 .* t\\w\\+\n', a)
+  call assert_match('\n *\d*\.\d* \+3 \+2 .* \\d\\+\n', a)
+  call assert_match('\n *\d*\.\d* \+1 \+1 .* e\\+\n', a)
+  call assert_match('\n *\d*\.\d* \+[1-9]\d* \+1 .* tw\[aeiou\]\n', a)
+  call assert_match('\n *\d*\.\d* .* 1 \+1 \+\\%#=0o\\{', a)
+
+  regexptime off
+  call search('off\d')
+  regexptime clear
+  let a = execute('regexptime report')
+  call assert_notmatch('off', a)
+  call assert_notmatch('\\d', a)
+
+  call assert_fails('regexptime abc', 'E475:')
+  call clearmatches()
+  bwipe!
+endfunc
+
+func Test_regexptime_completion()
+  CheckFeature profile
+
+  call feedkeys(":regexptime \<C-A>\<C-B>\"\<CR>", 'tx')
+  call assert_equal('"regexptime clear off on report', @:)
+endfunc
+
 " vim: shiftwidth=2 sts=2 expandtab
@@ -558,4 +558,41 @@ func Test_match_char_class_upper()
   bwipe!
 endfunc
 
+" The NFA engine first checks with a DFA whether a line can match, the DFA
+" states must not be used after 'iskeyword' or 'ignorecase' changed.
+func Test_regexp_dfa_prefilter()
+  new
+  call setline(1, ['foo-bar', 'xx FOO yy', 'ab', 'cd', "e\u0301f", 'x'])
+
+  let pat = '\%#=2\<\k\{7}\>'
+  call assert_equal(0, search(pat, 'cw'))
+  setlocal iskeyword+=-
+  call assert_equal(1, search(pat, 'cw'))
+  setlocal iskeyword-=-
+  call assert_equal(0, search(pat, 'cw'))
+
+  set noignorecase
+  call assert_equal(0, search('\%#=2fo\+ y', 'cw'))
+  set ignorecase
+  call assert_equal(2, search('\%#=2fo\+ y', 'cw'))
+  set noignorecase
+  call assert_equal(0, search('\%#=2fo\+ y', 'cw'))
+
+  " match continues in the next line
+  call assert_equal(3, search('\%#=2b\nc', 'cw'))
+  call assert_equal(0, search('\%#=2b\nx', 'cw'))
+
+  " composing character is handled by the NFA
+  call assert_equal(5, search("\\%#=2e\u0301f", 'cw'))
+  call assert_equal(0, search('\%#=2ef', 'cw'))
+
+  " many different DFA states
+  call setline(6, repeat('abcdefghijklmnopqrstuvwxyz', 20) .. 'xyzzy')
+  for i in range(20)
+    call assert_equal(6, search('\%#=2[a-z]\{' .. i .. '}xyzzy', 'cw'))
+    call assert_equal(0, search('\%#=2[a-z]\{' .. i .. '}zyzzy', 'cw'))
+  endfor
+  bwipe!
+endfunc
+
 " vim: shiftwidth=2 sts=2 expandtab
@@ -270,6 +270,40 @@ func Test_searchcount_fails()
   call assert_fails('echo searchcount({"pos" : [1, 2, []]})', 'E745:')
 endfunc
 
+" searchcount() finds all matches at once, the result must be the same as
+" when searching for each match.
+func Test_searchcount_same_as_search()
+  new
+  call setline(1, ['aaa baa', '', 'a', 'xaxa', 'end'])
+  let save_cpo = &cpo
+  for cpo in ['', 'c']
+    let &cpo = cpo
+    for pat in ['a', 'aa', '\<', '\>', '$', '^', 'a\|$', 'x*', 'a\zsa']
+      call cursor(1, 1)
+      let cnt = 0
+      let flags = 'cW'
+      while search(pat, flags) > 0
+        let cnt += 1
+        let flags = 'W'
+      endwhile
+      call cursor(1, 1)
+      let @/ = pat
+      let result = searchcount(#{maxcount: 0, pos: [4, 2, 0]})
+      call assert_equal(cnt, result.total, pat .. ' cpo=' .. cpo)
+    endfor
+  endfor
+  let &cpo = save_cpo
+
+  let @/ = 'a'
+  call assert_equal(#{current: 7, exact_match: 1, total: 8, incomplete: 0,
+        \ maxcount: 0}, searchcount(#{maxcount: 0, pos: [4, 2, 0]}))
+  call assert_equal(#{current: 6, exact_match: 0, total: 8, incomplete: 0,
+        \ maxcount: 0}, searchcount(#{maxcount: 0, pos: [4, 1, 0]}))
+  call assert_equal(#{current: 4, exact_match: 1, total: 5, incomplete: 2,
+        \ maxcount: 4}, searchcount(#{maxcount: 4, pos: [1, 6, 0]}))
+  bwipe!
+endfunc
+
 func Test_searchcount_in_statusline()
   CheckScreendump
 
@@ -943,4 +943,17 @@ func Test_substitute_skipped_range()
   bwipe!
 endfunc
 
+" Matching inside a "\=" expression must not change the outer match
+func Test_substitute_nested_match()
+  new
+  call setline(1, ['one two', 'three four'])
+  %s/\(\w\+\) \(\w\+\)/\=matchstr(submatch(2), '\%(o\)\@<=.')
+        \ .. substitute(submatch(1), '\(.\)\(.*\)', '\2\1', '')
+        \ .. match(getline('.'), submatch(2))/
+  call assert_equal(['neo4', 'uhreet6'], getline(1, '$'))
+  call assert_equal('bc|a', substitute('abc', '\(a\)\(.*\)',
+        \ '\=substitute(submatch(2), ".*", "&|", "") .. submatch(1)', ''))
+  bwipe!
+endfunc
+
 " vim: shiftwidth=2 sts=2 expandtab
@@ -167,6 +167,32 @@ func Test_swapname()
   call delete('Xtest3')
 endfunc
 
+" A read-only buffer doesn't get a swap file when all buffers together use
+" more than 'maxmemtot'.
+func Test_no_swapfile_for_readonly_buffer()
+  call writefile(repeat(['some text in the buffer'], 10000), 'Xreadonly')
+  set maxmemtot=1
+
+  view Xreadonly
+  call assert_equal(10000, line('$'))
+  call assert_equal('', swapname(''))
+  bwipe!
+
+  split Xreadonly
+  setlocal nomodifiable
+  edit
+  call assert_equal('', swapname(''))
+
+  " making a change creates the swap file
+  setlocal modifiable
+  normal! x
+  call assert_notequal('', swapname(''))
+  bwipe!
+
+  set maxmemtot&
+  call delete('Xreadonly')
+endfunc
+
 func Test_swapfile_delete()
   autocmd! SwapExists
   function s:swap_exists()
@@ -939,5 +939,194 @@ func Test_syn_include_contains_TOP()
   bw!
 endfunc
 
+func Test_syn_keyword_added_later()
+  new
+  call setline(1, 'foo Bar bazz QUUX ÄbÖ')
+  syn keyword xFoo foo
+  call assert_equal('xFoo', synIDattr(synID(1, 1, 1), 'name'))
+  call assert_equal('', synIDattr(synID(1, 5, 1), 'name'))
+
+  " Keywords added after the line was highlighted must be found.
+  syn keyword xBar Bar
+  syn case ignore
+  syn keyword xBazz BAZZ quux äbö
+  syn case match
+  call assert_equal('xBar', synIDattr(synID(1, 5, 1), 'name'))
+  call assert_equal('xBazz', synIDattr(synID(1, 9, 1), 'name'))
+  call assert_equal('xBazz', synIDattr(synID(1, 14, 1), 'name'))
+  call assert_equal('xBazz', synIDattr(synID(1, 19, 1), 'name'))
+
+  " A cleared keyword is not found.
+  syn clear xBar
+  call assert_equal('', synIDattr(synID(1, 5, 1), 'name'))
+  call assert_equal('xFoo', synIDattr(synID(1, 1, 1), 'name'))
+
+  syn clear
+  bwipe!
+endfunc
+
+" Return the number of times the "Comment" pattern was tried when displaying
+" the end of the current buffer.
+func s:CountCommentTries()
+  syn region Comment start=+/\*+ end=+\*/+
+  syn sync fromstart
+  syntime clear
+  syntime on
+  normal! G
+  redraw
+  syntime off
+  let report = split(execute('syntime report'), "\n")
+  return str2nr(split(filter(report, 'v:val =~ "Comment"')[0])[1])
+endfunc
+
+func Test_syntax_cache_file()
+  CheckFeature persistent_undo
+  CheckFeature profile
+  let lines = repeat(['text /* comment', 'more */ text'], 1000)
+  call writefile(lines, 'Xsyncache')
+  set undofile
+
+  " Nothing is written for a file without an undo file.
+  edit Xsyncache
+  let full_count = s:CountCommentTries()
+  bwipe!
+  call assert_false(filereadable('.Xsyncache.sy~'))
+
+  " When there is an undo file the states are written when the buffer is
+  " unloaded.
+  edit Xsyncache
+  call setline(1, lines[0])
+  write
+  call assert_true(filereadable('.Xsyncache.un~'))
+  call assert_inrange(full_count, full_count * 2, s:CountCommentTries())
+  bwipe!
+  call assert_true(filereadable('.Xsyncache.sy~'))
+
+  " Reading the same text again uses the stored states.
+  edit Xsyncache
+  call assert_inrange(1, full_count / 10, s:CountCommentTries())
+  call assert_equal('Comment', synIDattr(synID(2000, 1, 1), 'name'))
+  bwipe!
+
+  " Reloading changed text without an undo file does not use the states
+  " stored for the previous text.
+  edit Xsyncache
+  call delete('.Xsyncache.un~')
+  call writefile(['/*'] + lines, 'Xsyncache')
+  edit!
+  call assert_inrange(full_count, full_count * 2, s:CountCommentTries())
+  call assert_equal('', synIDattr(synID(2000, 1, 1), 'name'))
+  bwipe!
+
+  " Write the undo file and the states again.
+  call writefile(lines, 'Xsyncache')
+  edit Xsyncache
+  call s:CountCommentTries()
+  call setline(1, lines[0])
+  write
+  bwipe!
+
+  " The stored states are not used for changed text.
+  call writefile(['/*'] + lines, 'Xsyncache')
+  edit Xsyncache
+  call assert_inrange(full_count, full_count * 2, s:CountCommentTries())
+  call assert_equal('', synIDattr(synID(2000, 1, 1), 'name'))
+  bwipe!
+
+  set undofile&
+  call delete('Xsyncache')
+  call delete('.Xsyncache.un~')
+  call delete('.Xsyncache.sy~')
+endfunc
+
+" States stored while waiting for the user to type must give the same
+" highlighting as parsing the text normally, also after a change above the
+" parsed lines.
+func Test_syntax_idle_parse()
+  CheckRunVimInTerminal
+  CheckFeature profile
+  let lines = repeat(['text "str" x', 'code "a /* b', 'c */ d" y'], 5000)
+  call writefile(lines, 'Xidle.c')
+
+  let script =<< trim [CODE]
+    func SetSyntax()
+      syn region Comment start=+/\*+ end=+\*/+
+      syn region String start=+"+ skip=+\\"+ end=+"+
+      syn sync fromstart
+    endfunc
+    call SetSyntax()
+    redraw
+
+    " Return the number of times the Comment pattern was tried when
+    " displaying the end of the buffer.
+    func CountTries()
+      syntime clear
+      syntime on
+      normal! G
+      redraw
+      syntime off
+      let report = split(execute('syntime report'), "\n")
+      return str2nr(split(filter(report, 'v:val =~ "Comment"')[0])[1])
+    endfunc
+
+    " Return the syntax items of lines all over the buffer, last one first,
+    " so that each line is computed from a stored state.
+    func GetIds()
+      let ids = []
+      for lnum in range(line('$'), 1, -97)
+        call add(ids, [lnum, synID(lnum, 1, 1), synID(lnum, 9, 1)])
+      endfor
+      return ids
+    endfunc
+
+    " Check the states computed while waiting against parsing a copy of the
+    " text in another buffer.
+    func Check()
+      let idle_tries = CountTries()
+      let idle_ids = GetIds()
+      let text = getline(1, '$')
+      new
+      call setline(1, text)
+      call SetSyntax()
+      let tries = CountTries()
+      let ids = GetIds()
+      bwipe!
+      call assert_inrange(0, tries / 10, idle_tries)
+      call assert_equal(ids, idle_ids)
+      normal! gg
+      redraw
+    endfunc
+
+    func First(timer)
+      call Check()
+      call writefile(v:errors, 'Xresult')
+    endfunc
+
+    func Second(timer)
+      call Check()
+      call writefile(v:errors, 'Xresult2')
+    endfunc
+
+    call timer_start(1000, 'First')
+  [CODE]
+
+  call writefile(script, 'XidleParse.vim')
+
+  let buf = RunVimInTerminal('-S XidleParse.vim Xidle.c', {})
+  call WaitForAssert({-> assert_true(filereadable('Xresult'))}, 10000)
+  call assert_equal([], readfile('Xresult'))
+
+  " Removing a quote changes the syntax of all following lines.
+  call term_sendkeys(buf, "5GScode a\<Esc>gg")
+  call term_sendkeys(buf, ":call timer_start(1000, 'Second')\r")
+  call WaitForAssert({-> assert_true(filereadable('Xresult2'))}, 10000)
+  call assert_equal([], readfile('Xresult2'))
+
+  call StopVimInTerminal(buf)
+  call delete('Xidle.c')
+  call delete('XidleParse.vim')
+  call delete('Xresult')
+  call delete('Xresult2')
+endfunc
 
 " vim: shiftwidth=2 sts=2 expandtab
@@ -471,4 +471,25 @@ func Test_timer_outputting_message()
   call delete('XTest_timermessage')
 endfunc
 
+" garbagecollect() called from a timer is not replaced by a young collection
+" when waiting for a key.
+func Test_timer_garbagecollect()
+  CheckRunVimInTerminal
+
+  let lines =<< trim END
+      set updatetime=50
+      call timer_start(10, {-> garbagecollect()})
+      call timer_start(1000, {-> writefile(
+            \ [garbagecollect_info().full], 'XTimerGcResult')})
+  END
+  call writefile(lines, 'XTest_timergc')
+  let buf = RunVimInTerminal('-S XTest_timergc', #{rows: 6})
+  call WaitForAssert({-> assert_true(filereadable('XTimerGcResult'))})
+  call WaitForAssert({-> assert_equal(['1'], readfile('XTimerGcResult'))})
+
+  call StopVimInTerminal(buf)
+  call delete('XTest_timergc')
+  call delete('XTimerGcResult')
+endfunc
+
 " vim: shiftwidth=2 sts=2 expandtab
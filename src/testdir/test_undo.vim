@@ -416,6 +416,61 @@ func Test_undofile_next()
   set undofile&
 endfunc
 
+" Test that writing the undo file again only appends the new changes.
+func Test_undofile_append()
+  set undofile
+  new Xundoappend
+  let ufile = has('vms') ? '_un_Xundoappend' : '.Xundoappend.un~'
+  call setline(1, 'one')
+  write
+  let first = readfile(ufile, 'B')
+
+  " adding changes appends to the existing file
+  execute "norm otwo\<c-g>u\<CR>three\<Esc>"
+  write
+  let second = readfile(ufile, 'B')
+  call assert_true(len(second) > len(first))
+  call assert_equal(first, second[: len(first) - 1])
+  bwipe!
+
+  edit Xundoappend
+  call assert_equal(['one', 'two', 'three'], getline(1, '$'))
+  call assert_equal(3, undotree().seq_last)
+  silent undo
+  call assert_equal(['one', 'two'], getline(1, '$'))
+
+  " after undo a change creates a branch, the file is written again
+  call setline(2, 'TWO')
+  write
+  let third = readfile(ufile, 'B')
+  call assert_notequal(second, third[: len(second) - 1])
+  bwipe!
+
+  edit Xundoappend
+  call assert_equal(['one', 'TWO'], getline(1, '$'))
+  silent undo
+  call assert_equal(['one', 'two'], getline(1, '$'))
+  silent redo
+  call assert_equal(['one', 'TWO'], getline(1, '$'))
+  " also append after reading the undo file
+  for i in range(20)
+    call append('$', 'line' .. i)
+    write
+  endfor
+  bwipe!
+
+  edit Xundoappend
+  call assert_equal(24, undotree().seq_last)
+  call assert_equal('line19', getline('$'))
+  silent undo 4
+  call assert_equal(['one', 'TWO'], getline(1, '$'))
+  bwipe!
+
+  call delete('Xundoappend')
+  call delete(ufile)
+  set undofile&
+endfunc
+
 " Test for undo working properly when executing commands from a register.
 " Also test this in an empty buffer.
 func Test_cmd_in_reg_undo()
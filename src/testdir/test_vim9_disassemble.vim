@@ -207,7 +207,7 @@ def Test_disassemble_redir_var()
         ' redir END\_s*' ..
         '\d LOAD $0\_s*' ..
         '\d REDIR END\_s*' ..
-        '\d CONCAT\_s*' ..
+        '\d CONCAT size 2\_s*' ..
         '\d STORE $0\_s*' ..
         '\d RETURN void',
         res)
@@ -749,7 +749,7 @@ def Test_disassemble_closure()
         'local ..= arg\_s*' ..
         '\d LOADOUTER level 1 $0\_s*' ..
         '\d LOAD arg\[-1\]\_s*' ..
-        '\d CONCAT\_s*' ..
+        '\d CONCAT size 2\_s*' ..
         '\d STOREOUTER level 1 $0\_s*' ..
         '\d RETURN void',
         res)
@@ -839,7 +839,7 @@ def Test_disassemble_call_default()
         '6 LOAD arg\[-2]\_s*' ..
         '\d LOAD arg\[-1]\_s*' ..
         '\d 2STRING stack\[-1]\_s*' ..
-        '\d\+ CONCAT\_s*' ..
+        '\d\+ CONCAT size 2\_s*' ..
         '\d\+ RETURN',
         res)
 enddef
@@ -1100,9 +1100,8 @@ def Test_disassemble_lambda()
         '\d PUSHS "X"\_s*' ..
         '\d LOAD arg\[-1\]\_s*' ..
         '\d 2STRING_ANY stack\[-1\]\_s*' ..
-        '\d CONCAT\_s*' ..
         '\d PUSHS "X"\_s*' ..
-        '\d CONCAT\_s*' ..
+        '\d CONCAT size 3\_s*' ..
         '\d RETURN',
         instr)
 enddef
@@ -1255,7 +1254,7 @@ def Test_disassemble_for_loop_eval()
         '\d\+ LOAD $0\_s*' ..
         '\d\+ LOAD $2\_s*' ..
         '\d\+ CHECKTYPE string stack\[-1\]\_s*' ..
-        '\d\+ CONCAT\_s*' ..
+        '\d\+ CONCAT size 2\_s*' ..
         '\d\+ STORE $0\_s*' ..
         'endfor\_s*' ..
         '\d\+ JUMP -> 5\_s*' ..
@@ -1451,6 +1450,91 @@ def Test_disassemble_computing()
   endif
 enddef
 
+def FusedLoop(n: number, cond: bool): list<number>
+  var total = 0
+  var i = 0
+  while i < n
+    total = total + i
+    i += 1
+  endwhile
+  var x = 5
+  var res = cond ? x : total - i
+  return [total, i, res]
+enddef
+
+def Test_disassemble_fused()
+  # Sequences executed as one superinstruction are listed unchanged.
+  var instr = execute('disassemble FusedLoop')
+  assert_match('FusedLoop.*' ..
+        'while i < n.*' ..
+        '\d LOAD $1.*' ..
+        '\d LOAD arg\[-2].*' ..
+        '\d COMPARENR <.*' ..
+        '\d JUMP_IF_FALSE -> \d\+.*' ..
+        'total = total + i.*' ..
+        '\d LOAD $0.*' ..
+        '\d LOAD $1.*' ..
+        '\d OPNR +.*' ..
+        '\d STORE $0.*' ..
+        'i += 1.*' ..
+        '\d LOAD $1.*' ..
+        '\d PUSHNR 1.*' ..
+        '\d OPNR +.*' ..
+        '\d STORE $1.*',
+        instr)
+
+  # The jump for "cond" goes to the STORE halfway a sequence.
+  assert_equal([45, 10, 5], FusedLoop(10, true))
+  assert_equal([45, 10, 35], FusedLoop(10, false))
+  assert_equal([0, 0, 0], FusedLoop(0, false))
+enddef
+
+def FusedNumbers(a: number, b: number): list<any>
+  var r1 = a * b + (a - b) * 3 % 7
+  var r2 = a / 3 - -b
+  var lt = a + 1 < b * 2
+  var count = 0
+  if a % 2 == 0
+    count += 10
+  endif
+  while count * 2 <= a + b
+    count += 1
+  endwhile
+  return [r1, r2, lt, count]
+enddef
+
+def FusedFloats(a: float, b: float): list<any>
+  var r = a * b - (a + 0.5) / 2.0
+  var ge = a * 2.0 >= b
+  var count = 0
+  var f = a
+  while f < b
+    f = f * 2.0 + 1.0
+    count += 1
+  endwhile
+  return [r, ge, count, f]
+enddef
+
+def Test_fused_values()
+  # compare with evaluating the same expressions with legacy script
+  for [a, b] in [[7, 3], [-4, 9], [0, 1], [12, -5]]
+    var expected = [a * b + (a - b) * 3 % 7, a / 3 - -b, a + 1 < b * 2]
+    var count = a % 2 == 0 ? 10 : 0
+    while count * 2 <= a + b
+      count += 1
+    endwhile
+    assert_equal(expected + [count], FusedNumbers(a, b))
+  endfor
+  assert_equal(v:t_bool, type(FusedNumbers(1, 2)[2]))
+
+  if has('float')
+    assert_equal([3.5 * 9.0 - 4.0 / 2.0, false, 2, 17.0], FusedFloats(3.5, 9.0))
+    assert_equal([-0.5, true, 0, 0.5], FusedFloats(0.5, 0.0))
+    assert_equal(v:t_bool, type(FusedFloats(1.0, 2.0)[1]))
+    assert_equal(v:t_float, type(FusedFloats(1.0, 2.0)[3]))
+  endif
+enddef
+
 def AddListBlob()
   var reslist = [1, 2] + [3, 4]
   var resblob = 0z1122 + 0z3344
@@ -1489,12 +1573,37 @@ def Test_disassemble_concat()
         '\d LOADG g:aa.*' ..
         '\d PUSHS "bb".*' ..
         '\d 2STRING_ANY stack\[-2].*' ..
-        '\d CONCAT.*' ..
+        '\d CONCAT size 2.*' ..
         '\d STORE $.*',
         instr)
   assert_equal('aabb', ConcatString())
 enddef
 
+def ConcatChain(): string
+  var n = 3
+  var res = g:aa .. n .. "cc" .. g:aa
+  return res
+enddef
+
+def Test_disassemble_concat_chain()
+  var instr = execute('disassemble ConcatChain')
+  assert_match('ConcatChain\_s*' ..
+        'var n = 3\_s*' ..
+        '\d STORE 3 in $0\_s*' ..
+        'var res = g:aa .. n .. "cc" .. g:aa\_s*' ..
+        '\d LOADG g:aa\_s*' ..
+        '\d LOAD $0\_s*' ..
+        '\d 2STRING_ANY stack\[-2\]\_s*' ..
+        '\d 2STRING stack\[-1\]\_s*' ..
+        '\d PUSHS "cc"\_s*' ..
+        '\d LOADG g:aa\_s*' ..
+        '\d 2STRING_ANY stack\[-1\]\_s*' ..
+        '\d CONCAT size 4\_s*' ..
+        '\d STORE $1\_s*',
+        instr)
+  assert_equal('aa3ccaa', ConcatChain())
+enddef
+
 def StringIndex(): string
   var s = "abcd"
   var res = s[1]
@@ -1930,7 +2039,7 @@ def Test_disassemble_execute()
         "execute 'help ' .. tag\\_s*" ..
         '\d\+ PUSHS "help "\_s*' ..
         '\d\+ LOAD $1\_s*' ..
-        '\d\+ CONCAT\_s*' ..
+        '\d\+ CONCAT size 2\_s*' ..
         '\d\+ EXECUTE 1\_s*' ..
         '\d\+ RETURN void',
         res)
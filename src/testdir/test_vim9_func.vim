@@ -2900,6 +2900,52 @@ def Test_closing_brace_at_start_of_line()
   call CheckDefAndScriptSuccess(lines)
 enddef
 
+" A function looked up by name in compiled code is remembered until the
+" function table changes.
+func Test_call_cached_function()
+  func g:CachedFunc()
+    return 'one'
+  endfunc
+  func g:OtherFunc()
+    return 'other'
+  endfunc
+  def g:CallCached(name: string): list<string>
+    var Ref: func = function(name)
+    return [g:CachedFunc(), Ref()]
+  enddef
+  call assert_equal(['one', 'one'], g:CallCached('g:CachedFunc'))
+  call assert_equal(['one', 'other'], g:CallCached('g:OtherFunc'))
+  call assert_equal(['one', 'one'], g:CallCached('g:CachedFunc'))
+
+  " redefined in place
+  func! g:CachedFunc()
+    return 'two'
+  endfunc
+  call assert_equal(['two', 'two'], g:CallCached('g:CachedFunc'))
+
+  " still referenced, the name gets a new function
+  let g:KeepRef = funcref('g:CachedFunc')
+  func! g:CachedFunc()
+    return 'three'
+  endfunc
+  call assert_equal(['three', 'three'], g:CallCached('g:CachedFunc'))
+  call assert_equal('two', g:KeepRef())
+  unlet g:KeepRef
+  call assert_equal(['three', 'three'], g:CallCached('g:CachedFunc'))
+
+  delfunc g:CachedFunc
+  call assert_fails('call g:CallCached("g:OtherFunc")',
+        \ 'E117: Unknown function: CachedFunc')
+  func g:CachedFunc()
+    return 'four'
+  endfunc
+  call assert_equal(['four', 'other'], g:CallCached('g:OtherFunc'))
+
+  delfunc g:CachedFunc
+  delfunc g:OtherFunc
+  delfunc g:CallCached
+endfunc
+
 if has('python3')
   def Test_python3_heredoc()
     py3 << trim EOF
@@ -911,6 +911,10 @@ f_test_getvalue(typval_T *argvars, typval_T *rettv)
 
 	if (STRCMP(name, (char_u *)"need_fileinfo") == 0)
 	    rettv->vval.v_number = need_fileinfo;
+	else if (STRCMP(name, (char_u *)"regcache_hits") == 0)
+	    rettv->vval.v_number = regcache_hits;
+	else if (STRCMP(name, (char_u *)"regcache_misses") == 0)
+	    rettv->vval.v_number = regcache_misses;
 	else
 	    semsg(_(e_invarg2), name);
     }
@@ -1074,11 +1078,14 @@ f_test_refcount(typval_T *argvars, typval_T *rettv)
  * "test_garbagecollect_now()" function
  */
     void
-f_test_garbagecollect_now(typval_T *argvars UNUSED, typval_T *rettv UNUSED)
+f_test_garbagecollect_now(typval_T *argvars, typval_T *rettv UNUSED)
 {
     // This is dangerous, any Lists and Dicts used internally may be freed
     // while still in use.
-    garbage_collect(TRUE);
+    if (argvars[0].v_type != VAR_UNKNOWN && tv_get_bool(&argvars[0]))
+	garbage_collect_young();
+    else
+	garbage_collect(TRUE);
 }
 
 /*
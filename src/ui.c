@@ -277,6 +277,9 @@ inchar_loop(
     int		did_start_blocking = FALSE;
     long	wait_time;
     long	elapsed_time = 0;
+#if defined(FEAT_SYN_HL) && defined(FEAT_RELTIME)
+    int		syn_idle = FALSE;
+#endif
 #ifdef ELAPSED_FUNC
     elapsed_T	start_tv;
 
@@ -378,6 +381,14 @@ inchar_loop(
 	    wait_time = 100L;
 #endif
 
+#if defined(FEAT_SYN_HL) && defined(FEAT_RELTIME)
+	// When there is syntax to be parsed ahead, only check for a character
+	// and then parse for a short while.
+	syn_idle = wtime != 0 && syntax_idle_pending();
+	if (syn_idle)
+	    wait_time = 0L;
+#endif
+
 	// Wait for a character to be typed or another event, such as the winch
 	// signal or an event on the monitored file descriptors.
 	did_call_wait_func = TRUE;
@@ -405,6 +416,17 @@ inchar_loop(
 	elapsed_time += wait_time;
 #endif
 
+#if defined(FEAT_SYN_HL) && defined(FEAT_RELTIME)
+	if (syn_idle)
+	{
+	    syntax_idle_parse(SYN_IDLE_MSEC);
+# ifndef ELAPSED_FUNC
+	    elapsed_time += SYN_IDLE_MSEC;
+# endif
+	    continue;
+	}
+#endif
+
 	if ((resize_func != NULL && resize_func(TRUE))
 #if defined(FEAT_CLIENTSERVER) && defined(UNIX) && !defined(MAC_CLIENTSERVER)
 		|| server_waiting()
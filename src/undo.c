@@ -100,7 +100,7 @@ typedef struct {
 } bufinfo_T;
 
 
-static void u_unch_branch(u_header_T *uhp);
+static void u_unch_branch(buf_T *buf, u_header_T *uhp);
 static u_entry_T *u_get_headentry(void);
 static void u_getbot(void);
 static void u_doit(int count);
@@ -115,6 +115,7 @@ static void u_freeentry(u_entry_T *, long);
 static int undo_flush(bufinfo_T *bi);
 # endif
 static int undo_read(bufinfo_T *bi, char_u *buffer, size_t size);
+static int serialize_header_data(bufinfo_T *bi, char_u *hash);
 static int serialize_uep(bufinfo_T *bi, u_entry_T *uep);
 static u_entry_T *unserialize_uep(bufinfo_T *bi, int *error, char_u *file_name);
 static void serialize_pos(bufinfo_T *bi, pos_T pos);
@@ -126,6 +127,14 @@ static void u_saveline(linenr_T lnum);
 
 #define U_ALLOC_LINE(size) lalloc(size, FALSE)
 
+// Called when an undo header that may have been written to the undo file is
+// changed, the next write must then rewrite the whole file.
+#ifdef FEAT_PERSISTENT_UNDO
+# define U_FILE_CHANGED(buf) ((buf)->b_u_file_seq = 0)
+#else
+# define U_FILE_CHANGED(buf)
+#endif
+
 // used in undo_end() to report number of added and deleted lines
 static long	u_newcount, u_oldcount;
 
@@ -527,6 +536,7 @@ u_savecommon(
 	{
 	    curbuf->b_u_newhead = old_curhead->uh_next.ptr;
 	    curbuf->b_u_curhead = NULL;
+	    U_FILE_CHANGED(curbuf);
 	}
 
 	/*
@@ -777,6 +787,7 @@ nomem:
 # define UF_HEADER_END_MAGIC	0xe7aa	// magic after last header
 # define UF_ENTRY_MAGIC		0xf518	// magic at start of entry
 # define UF_ENTRY_END_MAGIC	0x3581	// magic after last entry
+# define UF_JOURNAL_MAGIC	0x4a0e	// magic before appended headers
 # define UF_VERSION		2	// 2-byte undofile version number
 # define UF_VERSION_CRYPT	0x8002	// idem, encrypted
 
@@ -789,19 +800,19 @@ nomem:
 static char_u e_not_open[] = N_("E828: Cannot open undo file for writing: %s");
 
 /*
- * Compute the hash for the current buffer text into hash[UNDO_HASH_SIZE].
+ * Compute the hash for the text of "buf" into hash[UNDO_HASH_SIZE].
  */
     void
-u_compute_hash(char_u *hash)
+u_compute_hash(buf_T *buf, char_u *hash)
 {
     context_sha256_T	ctx;
     linenr_T		lnum;
     char_u		*p;
 
     sha256_start(&ctx);
-    for (lnum = 1; lnum <= curbuf->b_ml.ml_line_count; ++lnum)
+    for (lnum = 1; lnum <= buf->b_ml.ml_line_count; ++lnum)
     {
-	p = ml_get(lnum);
+	p = ml_get_buf(buf, lnum, FALSE);
 	sha256_update(&ctx, p, (UINT32_T)(STRLEN(p) + 1));
     }
     sha256_finish(&ctx, hash);
@@ -812,10 +823,12 @@ u_compute_hash(char_u *hash)
  * When "reading" is TRUE find the file to read, go over all directories in
  * 'undodir'.
  * When "reading" is FALSE use the first name where the directory exists.
+ * When "ext" is not NULL it is used instead of ".un~" and also appended to
+ * the name in other directories, for another file stored with the undofile.
  * Returns NULL when there is no place to write or no file to read.
  */
     static char_u *
-u_get_undo_file_name(char_u *buf_ffname, int reading)
+u_get_undo_file_name(char_u *buf_ffname, int reading, char *ext)
 {
     char_u	*dirp;
     char_u	dir_name[IOSIZE + 1];
@@ -849,7 +862,8 @@ u_get_undo_file_name(char_u *buf_ffname, int reading)
 	{
 	    // Use same directory as the ffname,
 	    // "dir/name" -> "dir/.name.un~"
-	    undo_file_name = vim_strnsave(ffname, STRLEN(ffname) + 5);
+	    undo_file_name = vim_strnsave(ffname, STRLEN(ffname)
+					 + (ext == NULL ? 5 : STRLEN(ext) + 1));
 	    if (undo_file_name == NULL)
 		break;
 	    p = gettail(undo_file_name);
@@ -858,14 +872,14 @@ u_get_undo_file_name(char_u *buf_ffname, int reading)
 	    // use "dir/name" -> "dir/_un_name" - add _un_
 	    // at the beginning to keep the extension
 	    mch_memmove(p + 4,  p, STRLEN(p) + 1);
-	    mch_memmove(p, "_un_", 4);
+	    mch_memmove(p, ext == NULL ? "_un_" : "_sy_", 4);
 
 #else
 	    // Use same directory as the ffname,
 	    // "dir/name" -> "dir/.name.un~"
 	    mch_memmove(p + 1, p, STRLEN(p) + 1);
 	    *p = '.';
-	    STRCAT(p, ".un~");
+	    STRCAT(p, ext == NULL ? ".un~" : ext);
 #endif
 	}
 	else
@@ -883,6 +897,12 @@ u_get_undo_file_name(char_u *buf_ffname, int reading)
 			    *p = '%';
 		}
 		undo_file_name = concat_fnames(dir_name, munged_name, TRUE);
+		if (undo_file_name != NULL && ext != NULL)
+		{
+		    p = concat_str(undo_file_name, (char_u *)ext);
+		    vim_free(undo_file_name);
+		    undo_file_name = p;
+		}
 	    }
 	}
 
@@ -897,6 +917,29 @@ u_get_undo_file_name(char_u *buf_ffname, int reading)
     return undo_file_name;
 }
 
+#if defined(FEAT_SYN_HL) || defined(PROTO)
+/*
+ * Return an allocated string of the full path of the syntax cache file.  It
+ * is located like the undofile, see u_get_undo_file_name().
+ */
+    char_u *
+u_get_syn_cache_name(char_u *buf_ffname, int reading)
+{
+    return u_get_undo_file_name(buf_ffname, reading, ".sy~");
+}
+
+/*
+ * Remember "hash" as the hash of the text of "buf" for which there is an undo
+ * file.  The syntax cache is only written while the text is unchanged.
+ */
+    static void
+u_set_syn_cache_hash(buf_T *buf, char_u *hash)
+{
+    mch_memmove(buf->b_syn_cache_hash, hash, UNDO_HASH_SIZE);
+    buf->b_syn_cache_hash_ok = TRUE;
+}
+#endif
+
     static void
 corruption_error(char *mesg, char_u *file_name)
 {
@@ -1192,10 +1235,11 @@ read_string_decrypt(bufinfo_T *bi, int len)
     static int
 serialize_header(bufinfo_T *bi, char_u *hash)
 {
+#ifdef FEAT_CRYPT
     long	len;
     buf_T	*buf = bi->bi_buf;
+#endif
     FILE	*fp = bi->bi_fp;
-    char_u	time_buf[8];
 
     // Start writing, first the magic marker and undo info version.
     if (fwrite(UF_START_MAGIC, (size_t)UF_START_MAGIC_LEN, (size_t)1, fp) != 1)
@@ -1239,6 +1283,19 @@ serialize_header(bufinfo_T *bi, char_u *hash)
 #endif
 	undo_write_bytes(bi, (long_u)UF_VERSION, 2);
 
+    return serialize_header_data(bi, hash);
+}
+
+/*
+ * Write the buffer-specific data of the undo file header.  This is also
+ * written before each group of headers appended to the file.
+ */
+    static int
+serialize_header_data(bufinfo_T *bi, char_u *hash)
+{
+    long	len;
+    buf_T	*buf = bi->bi_buf;
+    char_u	time_buf[8];
 
     // Write a hash of the buffer text, so that we can verify it is still the
     // same when reading the buffer text.
@@ -1543,6 +1600,120 @@ unserialize_visualinfo(bufinfo_T *bi, visualinfo_T *info)
     info->vi_curswant = undo_read_4c(bi);
 }
 
+/*
+ * Remember the state of undo file "file_name" after writing or reading it,
+ * so that the next write can append to it.  "full" is TRUE when the file was
+ * just written in full.
+ */
+    static void
+u_undo_file_done(buf_T *buf, char_u *file_name, int full)
+{
+    stat_T	st;
+
+    if (buf->b_u_curhead != NULL || buf->b_u_newhead == NULL
+# ifdef FEAT_CRYPT
+	    || *buf->b_p_key != NUL
+# endif
+	    || mch_stat((char *)file_name, &st) < 0)
+    {
+	U_FILE_CHANGED(buf);
+	return;
+    }
+    buf->b_u_file_seq = buf->b_u_seq_last;
+    buf->b_u_file_newhead = buf->b_u_newhead->uh_seq;
+    if (full)
+	buf->b_u_file_base = st.st_size;
+    buf->b_u_file_size = st.st_size;
+    buf->b_u_file_mtime = st.st_mtime;
+# ifdef UNIX
+    buf->b_u_file_ino = st.st_ino;
+# endif
+}
+
+/*
+ * Append the undo headers added since undo file "file_name" was written or
+ * read, instead of writing the whole undo tree again.  Only possible when no
+ * other header was changed and the file was not touched.  Once the appended
+ * part is bigger than the rest, the file is compacted by a full write.
+ * Returns FAIL when the file must be written in full.
+ */
+    static int
+u_append_undo(char_u *file_name, buf_T *buf, char_u *hash)
+{
+    u_header_T	*uhp;
+    stat_T	st;
+    int		fd;
+    FILE	*fp;
+    bufinfo_T	bi;
+    int		write_ok;
+
+    // Undo must be synced.
+    u_sync(TRUE);
+
+    if (buf->b_u_file_seq == 0 || buf->b_u_curhead != NULL
+# ifdef FEAT_CRYPT
+	    || *buf->b_p_key != NUL
+# endif
+	    || buf->b_u_file_size - buf->b_u_file_base > buf->b_u_file_base)
+	return FAIL;
+
+    // The newest header that was written before must still be there, it is
+    // written again because its links change.
+    for (uhp = buf->b_u_newhead; uhp != NULL
+				 && uhp->uh_seq > buf->b_u_file_seq;
+							 uhp = uhp->uh_next.ptr)
+	;
+    if (uhp == NULL || uhp->uh_seq != buf->b_u_file_newhead)
+	return FAIL;
+
+    if (mch_stat((char *)file_name, &st) < 0
+	    || st.st_size != buf->b_u_file_size
+	    || st.st_mtime != buf->b_u_file_mtime
+# ifdef UNIX
+	    || st.st_ino != buf->b_u_file_ino
+# endif
+	    )
+	return FAIL;
+
+    fd = mch_open((char *)file_name, O_WRONLY|O_APPEND|O_EXTRA|O_NOFOLLOW, 0);
+    if (fd < 0)
+	return FAIL;
+    fp = fdopen(fd, "a");
+    if (fp == NULL)
+    {
+	close(fd);
+	return FAIL;
+    }
+    if (p_verbose > 0)
+    {
+	verbose_enter();
+	smsg(_("Appending to undo file: %s"), file_name);
+	verbose_leave();
+    }
+
+    CLEAR_FIELD(bi);
+    bi.bi_buf = buf;
+    bi.bi_fp = fp;
+    write_ok = undo_write_bytes(&bi, (long_u)UF_JOURNAL_MAGIC, 2) == OK
+			    && serialize_header_data(&bi, hash) == OK;
+    for (uhp = buf->b_u_newhead; write_ok && uhp != NULL;
+							 uhp = uhp->uh_next.ptr)
+    {
+	write_ok = serialize_uhp(&bi, uhp) == OK;
+	if (uhp->uh_seq == buf->b_u_file_newhead)
+	    break;
+    }
+    if (write_ok)
+	write_ok = undo_write_bytes(&bi, (long_u)UF_HEADER_END_MAGIC, 2) == OK;
+    if (fclose(fp) != 0)
+	write_ok = FALSE;
+    if (!write_ok)
+	return FAIL;
+
+    u_undo_file_done(buf, file_name, FALSE);
+    return OK;
+}
+
 /*
  * Write the undo tree in an undo file.
  * When "name" is not NULL, use it as the name of the undo file.
@@ -1580,7 +1751,7 @@ u_write_undo(
 
     if (name == NULL)
     {
-	file_name = u_get_undo_file_name(buf->b_ffname, FALSE);
+	file_name = u_get_undo_file_name(buf->b_ffname, FALSE, NULL);
 	if (file_name == NULL)
 	{
 	    if (p_verbose > 0)
@@ -1596,6 +1767,14 @@ u_write_undo(
     else
 	file_name = name;
 
+    // When only headers were added append them to the existing file.
+    if (name == NULL && u_append_undo(file_name, buf, hash) == OK)
+    {
+	write_ok = TRUE;
+	goto theend;
+    }
+    U_FILE_CHANGED(buf);
+
     /*
      * Decide about the permission to use for the undo file.  If the buffer
      * has a name use the permission of the original file.  Otherwise only
@@ -1808,8 +1987,14 @@ write_error:
 	mch_free_acl(acl);
     }
 #endif
+    if (name == NULL && write_ok)
+	u_undo_file_done(buf, file_name, TRUE);
 
 theend:
+#ifdef FEAT_SYN_HL
+    if (name == NULL && write_ok)
+	u_set_syn_cache_hash(buf, hash);
+#endif
 #ifdef FEAT_CRYPT
     if (bi.bi_state != NULL)
 	crypt_free_state(bi.bi_state);
@@ -1842,6 +2027,8 @@ u_read_undo(char_u *name, char_u *hash, char_u *orig_name UNUSED)
     long	last_save_nr = 0;
     short	old_idx = -1, new_idx = -1, cur_idx = -1;
     long	num_read_uhps = 0;
+    long	num_alloc_uhps = 0;
+    long	base_len = -1;
     time_t	seq_time;
     int		i, j;
     int		c;
@@ -1864,7 +2051,11 @@ u_read_undo(char_u *name, char_u *hash, char_u *orig_name UNUSED)
 
     if (name == NULL)
     {
-	file_name = u_get_undo_file_name(curbuf->b_ffname, TRUE);
+#ifdef FEAT_SYN_HL
+	// Set again below when there is an undo file for the text.
+	curbuf->b_syn_cache_hash_ok = FALSE;
+#endif
+	file_name = u_get_undo_file_name(curbuf->b_ffname, TRUE, NULL);
 	if (file_name == NULL)
 	    return;
 
@@ -1885,6 +2076,9 @@ u_read_undo(char_u *name, char_u *hash, char_u *orig_name UNUSED)
 	    }
 	    return;
 	}
+#endif
+#ifdef FEAT_SYN_HL
+	u_set_syn_cache_hash(curbuf, hash);
 #endif
     }
     else
@@ -1955,108 +2149,146 @@ u_read_undo(char_u *name, char_u *hash, char_u *orig_name UNUSED)
 	goto error;
     }
 
-    if (undo_read(&bi, read_hash, (size_t)UNDO_HASH_SIZE) == FAIL)
-    {
-	corruption_error("hash", file_name);
-	goto error;
-    }
-    line_count = (linenr_T)undo_read_4c(&bi);
-    if (memcmp(hash, read_hash, UNDO_HASH_SIZE) != 0
-				  || line_count != curbuf->b_ml.ml_line_count)
+    // The header data is followed by the undo headers.  When headers were
+    // appended to the file this repeats, a header with a sequence number
+    // that was already read replaces the earlier one.
+    for (;;)
     {
-	if (p_verbose > 0 || name != NULL)
+	if (undo_read(&bi, read_hash, (size_t)UNDO_HASH_SIZE) == FAIL)
 	{
-	    if (name == NULL)
-		verbose_enter();
-	    give_warning((char_u *)
-		      _("File contents changed, cannot use undo info"), TRUE);
-	    if (name == NULL)
-		verbose_leave();
+	    corruption_error("hash", file_name);
+	    goto error;
 	}
-	goto error;
-    }
-
-    // Read undo data for "U" command.
-    str_len = undo_read_4c(&bi);
-    if (str_len < 0)
-	goto error;
-    if (str_len > 0)
-    {
-	line_ptr.ul_line = read_string_decrypt(&bi, str_len);
-	line_ptr.ul_len = str_len + 1;
-    }
-    line_lnum = (linenr_T)undo_read_4c(&bi);
-    line_colnr = (colnr_T)undo_read_4c(&bi);
-    if (line_lnum < 0 || line_colnr < 0)
-    {
-	corruption_error("line lnum/col", file_name);
-	goto error;
-    }
+	line_count = (linenr_T)undo_read_4c(&bi);
 
-    // Begin general undo data
-    old_header_seq = undo_read_4c(&bi);
-    new_header_seq = undo_read_4c(&bi);
-    cur_header_seq = undo_read_4c(&bi);
-    num_head = undo_read_4c(&bi);
-    seq_last = undo_read_4c(&bi);
-    seq_cur = undo_read_4c(&bi);
-    seq_time = undo_read_time(&bi);
+	// Read undo data for "U" command.
+	VIM_CLEAR(line_ptr.ul_line);
+	line_ptr.ul_len = 0;
+	str_len = undo_read_4c(&bi);
+	if (str_len < 0)
+	    goto error;
+	if (str_len > 0)
+	{
+	    line_ptr.ul_line = read_string_decrypt(&bi, str_len);
+	    line_ptr.ul_len = str_len + 1;
+	}
+	line_lnum = (linenr_T)undo_read_4c(&bi);
+	line_colnr = (colnr_T)undo_read_4c(&bi);
+	if (line_lnum < 0 || line_colnr < 0)
+	{
+	    corruption_error("line lnum/col", file_name);
+	    goto error;
+	}
 
-    // Optional header fields.
-    for (;;)
-    {
-	int len = undo_read_byte(&bi);
-	int what;
+	// Begin general undo data
+	old_header_seq = undo_read_4c(&bi);
+	new_header_seq = undo_read_4c(&bi);
+	cur_header_seq = undo_read_4c(&bi);
+	num_head = undo_read_4c(&bi);
+	seq_last = undo_read_4c(&bi);
+	seq_cur = undo_read_4c(&bi);
+	seq_time = undo_read_time(&bi);
 
-	if (len == 0 || len == EOF)
-	    break;
-	what = undo_read_byte(&bi);
-	switch (what)
+	// Optional header fields.
+	for (;;)
 	{
-	    case UF_LAST_SAVE_NR:
-		last_save_nr = undo_read_4c(&bi);
+	    int len = undo_read_byte(&bi);
+	    int what;
+
+	    if (len == 0 || len == EOF)
 		break;
-	    default:
-		// field not supported, skip
-		while (--len >= 0)
-		    (void)undo_read_byte(&bi);
+	    what = undo_read_byte(&bi);
+	    switch (what)
+	    {
+		case UF_LAST_SAVE_NR:
+		    last_save_nr = undo_read_4c(&bi);
+		    break;
+		default:
+		    // field not supported, skip
+		    while (--len >= 0)
+			(void)undo_read_byte(&bi);
+	    }
 	}
-    }
 
-    // uhp_table will store the freshly created undo headers we allocate
-    // until we insert them into curbuf. The table remains sorted by the
-    // sequence numbers of the headers.
-    // When there are no headers uhp_table is NULL.
-    if (num_head > 0)
-    {
-	if (num_head < LONG_MAX / (long)sizeof(u_header_T *))
-	    uhp_table = U_ALLOC_LINE(num_head * sizeof(u_header_T *));
-	if (uhp_table == NULL)
-	    goto error;
-    }
+	// uhp_table will store the freshly created undo headers we allocate
+	// until we insert them into curbuf. The table remains sorted by the
+	// sequence numbers of the headers.
+	// When there are no headers uhp_table is NULL.
+	if (num_head > num_alloc_uhps)
+	{
+	    u_header_T	**new_table = NULL;
 
-    while ((c = undo_read_2c(&bi)) == UF_HEADER_MAGIC)
-    {
-	if (num_read_uhps >= num_head)
+	    if (num_head < LONG_MAX / (long)sizeof(u_header_T *))
+		new_table = U_ALLOC_LINE(num_head * sizeof(u_header_T *));
+	    if (new_table == NULL)
+		goto error;
+	    if (num_read_uhps > 0)
+		mch_memmove(new_table, uhp_table,
+				     num_read_uhps * sizeof(u_header_T *));
+	    vim_free(uhp_table);
+	    uhp_table = new_table;
+	    num_alloc_uhps = num_head;
+	}
+
+	while ((c = undo_read_2c(&bi)) == UF_HEADER_MAGIC)
 	{
-	    corruption_error("num_head too small", file_name);
-	    goto error;
+	    uhp = unserialize_uhp(&bi, file_name);
+	    if (uhp == NULL)
+		goto error;
+
+	    // An appended header may replace one that was read before.
+	    j = num_read_uhps;
+	    if (base_len >= 0)
+		for (j = 0; j < num_read_uhps; ++j)
+		    if (uhp_table[j]->uh_seq == uhp->uh_seq)
+			break;
+	    if (j < num_read_uhps)
+		u_free_uhp(uhp_table[j]);
+	    else if (num_read_uhps >= num_head)
+	    {
+		u_free_uhp(uhp);
+		corruption_error("num_head too small", file_name);
+		goto error;
+	    }
+	    else
+		++num_read_uhps;
+	    uhp_table[j] = uhp;
 	}
 
-	uhp = unserialize_uhp(&bi, file_name);
-	if (uhp == NULL)
+	if (num_read_uhps != num_head)
+	{
+	    corruption_error("num_head", file_name);
 	    goto error;
-	uhp_table[num_read_uhps++] = uhp;
-    }
+	}
+	if (c != UF_HEADER_END_MAGIC)
+	{
+	    corruption_error("end marker", file_name);
+	    goto error;
+	}
 
-    if (num_read_uhps != num_head)
-    {
-	corruption_error("num_head", file_name);
-	goto error;
+#ifdef FEAT_CRYPT
+	// Nothing is appended to an encrypted undo file.
+	if (bi.bi_state != NULL)
+	    break;
+#endif
+	if (base_len < 0)
+	    base_len = ftell(fp);
+	if (undo_read_2c(&bi) != UF_JOURNAL_MAGIC)
+	    break;
     }
-    if (c != UF_HEADER_END_MAGIC)
+
+    if (memcmp(hash, read_hash, UNDO_HASH_SIZE) != 0
+				  || line_count != curbuf->b_ml.ml_line_count)
     {
-	corruption_error("end marker", file_name);
+	if (p_verbose > 0 || name != NULL)
+	{
+	    if (name == NULL)
+		verbose_enter();
+	    give_warning((char_u *)
+		      _("File contents changed, cannot use undo info"), TRUE);
+	    if (name == NULL)
+		verbose_leave();
+	}
 	goto error;
     }
 
@@ -2150,6 +2382,13 @@ u_read_undo(char_u *name, char_u *hash, char_u *orig_name UNUSED)
     curbuf->b_u_synced = TRUE;
     vim_free(uhp_table);
 
+    // Further writes may append to this file.
+    if (name == NULL)
+    {
+	u_undo_file_done(curbuf, file_name, FALSE);
+	curbuf->b_u_file_base = base_len;
+    }
+
 #ifdef U_DEBUG
     for (i = 0; i < num_head; ++i)
 	if (uhp_table_used[i] == 0)
@@ -2610,6 +2849,7 @@ target_zero:
 		    uhp = last;
 		    if (uhp->uh_next.ptr != NULL)
 			uhp->uh_next.ptr->uh_prev.ptr = uhp;
+		    U_FILE_CHANGED(curbuf);
 		}
 		curbuf->b_u_curhead = uhp;
 
@@ -2685,6 +2925,7 @@ u_undoredo(int undo)
 #ifdef U_DEBUG
     u_check(FALSE);
 #endif
+    U_FILE_CHANGED(curbuf);
     old_flags = curhead->uh_flags;
     new_flags = (curbuf->b_changed ? UH_CHANGED : 0) +
 	       ((curbuf->b_ml.ml_flags & ML_EMPTY) ? UH_EMPTYBUF : 0);
@@ -3196,7 +3437,7 @@ ex_undojoin(exarg_T *eap UNUSED)
     void
 u_unchanged(buf_T *buf)
 {
-    u_unch_branch(buf->b_u_oldhead);
+    u_unch_branch(buf, buf->b_u_oldhead);
     buf->b_did_warn = FALSE;
 }
 
@@ -3213,6 +3454,7 @@ u_find_first_changed(void)
 
     if (curbuf->b_u_curhead != NULL || uhp == NULL)
 	return;  // undid something in an autocmd?
+    U_FILE_CHANGED(curbuf);
 
     // Check that the last undo block was for the whole file.
     uep = uhp->uh_entry;
@@ -3261,15 +3503,19 @@ u_update_save_nr(buf_T *buf)
 }
 
     static void
-u_unch_branch(u_header_T *uhp)
+u_unch_branch(buf_T *buf, u_header_T *uhp)
 {
     u_header_T	*uh;
 
     for (uh = uhp; uh != NULL; uh = uh->uh_prev.ptr)
     {
+#ifdef FEAT_PERSISTENT_UNDO
+	if (!(uh->uh_flags & UH_CHANGED) && uh->uh_seq <= buf->b_u_file_seq)
+	    U_FILE_CHANGED(buf);
+#endif
 	uh->uh_flags |= UH_CHANGED;
 	if (uh->uh_alt_next.ptr != NULL)
-	    u_unch_branch(uh->uh_alt_next.ptr);	    // recursive
+	    u_unch_branch(buf, uh->uh_alt_next.ptr);	    // recursive
     }
 }
 
@@ -3338,6 +3584,8 @@ u_freeheader(
 {
     u_header_T	    *uhap;
 
+    U_FILE_CHANGED(buf);
+
     // When there is an alternate redo list free that branch completely,
     // because we can never go there.
     if (uhp->uh_alt_next.ptr != NULL)
@@ -3382,6 +3630,7 @@ u_freebranch(
 	return;
     }
 
+    U_FILE_CHANGED(buf);
     if (uhp->uh_alt_prev.ptr != NULL)
 	uhp->uh_alt_prev.ptr->uh_alt_next.ptr = NULL;
 
@@ -3453,6 +3702,7 @@ u_clearall(buf_T *buf)
     buf->b_u_newhead = buf->b_u_oldhead = buf->b_u_curhead = NULL;
     buf->b_u_synced = TRUE;
     buf->b_u_numhead = 0;
+    U_FILE_CHANGED(buf);
     buf->b_u_line_ptr.ul_line = NULL;
     buf->b_u_line_ptr.ul_len = 0;
     buf->b_u_line_lnum = 0;
@@ -3661,7 +3911,8 @@ f_undofile(typval_T *argvars UNUSED, typval_T *rettv)
 	    char_u *ffname = FullName_save(fname, TRUE);
 
 	    if (ffname != NULL)
-		rettv->vval.v_string = u_get_undo_file_name(ffname, FALSE);
+		rettv->vval.v_string = u_get_undo_file_name(ffname, FALSE,
+									NULL);
 	    vim_free(ffname);
 	}
     }
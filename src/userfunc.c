@@ -1810,6 +1810,17 @@ find_func(char_u *name, int is_global, cctx_T *cctx)
     return NULL;
 }
 
+/*
+ * Return a number that changes whenever a function is added to, removed from
+ * or replaced in the function table.  Compiled code uses this to find out
+ * whether a function it looked up by name before can still be used.
+ */
+    int
+func_hashtab_changed(void)
+{
+    return func_hashtab.ht_changed;
+}
+
 /*
  * Return TRUE if "ufunc" is a global function.
  */
@@ -4246,6 +4257,8 @@ define_function(exarg_T *eap, char_u *name_arg)
 	{
 	    hi = hash_find(&func_hashtab, name);
 	    hi->hi_key = UF2HIKEY(fp);
+	    // the name now refers to another function
+	    ++func_hashtab.ht_changed;
 	}
 	else if (hash_add(&func_hashtab, UF2HIKEY(fp)) == FAIL)
 	{
@@ -867,6 +867,7 @@ extern int (*dyn_libintl_wputenv)(const wchar_t *envstring);
 # define SST_FIX_STATES	 7	// size of sst_stack[].
 # define SST_DIST	 16	// normal distance between entries
 # define SST_INVALID	(synstate_T *)-1	// invalid syn_state pointer
+# define SYN_IDLE_MSEC	 20	// msec to parse ahead while waiting
 
 # define HL_CONTAINED	0x01	// not used on toplevel
 # define HL_TRANSP	0x02	// has no highlighting
@@ -134,7 +134,7 @@ typedef enum {
     ISN_COMPAREANY,
 
     // expression operations
-    ISN_CONCAT,
+    ISN_CONCAT,	    // concatenate isn_arg.number strings on the stack
     ISN_STRINDEX,   // [expr] string index
     ISN_STRSLICE,   // [expr:expr] string slice
     ISN_LISTAPPEND, // append to a list, like add()
@@ -180,9 +180,20 @@ typedef enum {
     ISN_CEXPR_AUCMD, // first part of :cexpr  isn_arg.number is cmdidx
     ISN_CEXPR_CORE,  // second part of :cexpr, uses isn_arg.cexpr
 
+    // Superinstructions, see fuse_instructions().  They replace the LOAD
+    // that starts a sequence, the others are kept to be used when jumping
+    // into the middle.
+    ISN_LOAD_EXPRNR,	// LOAD, LOAD/PUSHNR/OPNR, then COMPARENR or OPNR,
+			// then STORE or JUMP_IF_FALSE
+    ISN_LOAD_EXPRFLOAT,	// LOAD, LOAD/PUSHF/OPFLOAT, then COMPAREFLOAT or
+			// OPFLOAT, then STORE or JUMP_IF_FALSE
+
     ISN_FINISH	    // end marker in list of instructions
 } isntype_T;
 
+// Maximum number of values a superinstruction keeps in registers.
+#define FUSED_REG_COUNT 8
+
 
 // arguments to ISN_BCALL
 typedef struct {
@@ -196,15 +207,25 @@ typedef struct {
     int	    cdf_argcount;   // number of arguments on top of stack
 } cdfunc_T;
 
+// Inline cache for a function that is looked up by name at runtime.  The
+// found function can be used as long as "fc_changed" equals
+// func_hashtab_changed().
+typedef struct {
+    char_u  *fc_name;	    // name to look up, allocated
+    ufunc_T *fc_ufunc;	    // function found for "fc_name", NULL if not set
+    int	    fc_changed;	    // func_hashtab_changed() for "fc_ufunc"
+} funccache_T;
+
 // arguments to ISN_PCALL
 typedef struct {
     int	    cpf_top;	    // when TRUE partial is above the arguments
     int	    cpf_argcount;   // number of arguments on top of stack
+    funccache_T *cpf_cache; // last funcref name called, NULL if none
 } cpfunc_T;
 
 // arguments to ISN_UCALL and ISN_XCALL
 typedef struct {
-    char_u  *cuf_name;
+    funccache_T *cuf_cache; // function name and the function found for it
     int	    cuf_argcount;   // number of arguments on top of stack
 } cufunc_T;
 
@@ -1914,6 +1914,26 @@ func_needs_compiling(ufunc_T *ufunc, compiletype_T compile_type)
     return FALSE;
 }
 
+/*
+ * Allocate an inline cache for looking up function "name" at runtime.
+ * Returns NULL when out of memory.
+ */
+    static funccache_T *
+alloc_funccache(char_u *name)
+{
+    funccache_T *fc = ALLOC_CLEAR_ONE(funccache_T);
+
+    if (fc == NULL)
+	return NULL;
+    fc->fc_name = vim_strsave(name);
+    if (fc->fc_name == NULL)
+    {
+	vim_free(fc);
+	return NULL;
+    }
+    return fc;
+}
+
 /*
  * Generate an ISN_DCALL or ISN_UCALL instruction.
  * Return FAIL if the number of arguments is wrong.
@@ -1998,8 +2018,11 @@ generate_CALL(cctx_T *cctx, ufunc_T *ufunc, int pushed_argcount)
     else
     {
 	// A user function may be deleted and redefined later, can't use the
-	// ufunc pointer, need to look it up again at runtime.
-	isn->isn_arg.ufunc.cuf_name = vim_strsave(ufunc->uf_name);
+	// ufunc pointer, need to look it up again at runtime.  The result is
+	// cached until the function table changes.
+	isn->isn_arg.ufunc.cuf_cache = alloc_funccache(ufunc->uf_name);
+	if (isn->isn_arg.ufunc.cuf_cache == NULL)
+	    return FAIL;
 	isn->isn_arg.ufunc.cuf_argcount = argcount;
     }
 
@@ -2025,7 +2048,9 @@ generate_UCALL(cctx_T *cctx, char_u *name, int argcount)
     RETURN_OK_IF_SKIP(cctx);
     if ((isn = generate_instr(cctx, ISN_UCALL)) == NULL)
 	return FAIL;
-    isn->isn_arg.ufunc.cuf_name = vim_strsave(name);
+    isn->isn_arg.ufunc.cuf_cache = alloc_funccache(name);
+    if (isn->isn_arg.ufunc.cuf_cache == NULL)
+	return FAIL;
     isn->isn_arg.ufunc.cuf_argcount = argcount;
 
     stack->ga_len -= argcount; // drop the arguments
@@ -2239,6 +2264,22 @@ generate_LEGACY_EVAL(cctx_T *cctx, char_u *line)
     return OK;
 }
 
+/*
+ * Generate an ISN_CONCAT instruction.
+ * "count" is the number of strings on the stack to concatenate.
+ */
+    static int
+generate_CONCAT(cctx_T *cctx, int count)
+{
+    isn_T	*isn;
+
+    RETURN_OK_IF_SKIP(cctx);
+    if ((isn = generate_instr_drop(cctx, ISN_CONCAT, count - 1)) == NULL)
+	return FAIL;
+    isn->isn_arg.number = count;
+    return OK;
+}
+
     static int
 generate_EXECCONCAT(cctx_T *cctx, int count)
 {
@@ -4852,6 +4893,7 @@ compile_expr5(char_u **arg, cctx_T *cctx, ppconst_T *ppconst)
     char_u	*next;
     int		oplen;
     int		ppconst_used = ppconst->pp_used;
+    int		concat_count = 0;
 
     // get the first variable
     if (compile_expr6(arg, cctx, ppconst) == FAIL)
@@ -4870,6 +4912,15 @@ compile_expr5(char_u **arg, cctx_T *cctx, ppconst_T *ppconst)
 	    // But ".." is concatenation.
 	    break;
 	oplen = (*op == '.' ? 2 : 1);
+
+	// "a .. b .. c + d" is "(a .. b .. c) + d", finish the concatenation
+	// before the next operand.
+	if (*op != '.' && concat_count > 0)
+	{
+	    if (generate_CONCAT(cctx, concat_count) == FAIL)
+		return FAIL;
+	    concat_count = 0;
+	}
 	if (next != NULL)
 	{
 	    *arg = next_line_from_context(cctx, TRUE);
@@ -4930,16 +4981,21 @@ compile_expr5(char_u **arg, cctx_T *cctx, ppconst_T *ppconst)
 	    ppconst->pp_is_const = FALSE;
 	    if (*op == '.')
 	    {
-		if (may_generate_2STRING(-2, FALSE, cctx) == FAIL
+		// Concatenate all strings in "a .. b .. c" at once, so that no
+		// string is allocated for the intermediate result.
+		if ((concat_count == 0
+			    && may_generate_2STRING(-2, FALSE, cctx) == FAIL)
 			|| may_generate_2STRING(-1, FALSE, cctx) == FAIL)
 		    return FAIL;
-		generate_instr_drop(cctx, ISN_CONCAT, 1);
+		concat_count = concat_count == 0 ? 2 : concat_count + 1;
 	    }
 	    else
 		generate_two_op(cctx, op);
 	}
     }
 
+    if (concat_count > 0)
+	return generate_CONCAT(cctx, concat_count);
     return OK;
 }
 
@@ -6965,7 +7021,7 @@ compile_assignment(char_u *arg, exarg_T *eap, cmdidx_T cmdidx, cctx_T *cctx)
 
 	    if (*op == '.')
 	    {
-		if (generate_instr_drop(cctx, ISN_CONCAT, 1) == NULL)
+		if (generate_CONCAT(cctx, 2) == FAIL)
 		    goto theend;
 	    }
 	    else if (*op == '+')
@@ -8935,7 +8991,7 @@ compile_redir(char_u *line, exarg_T *eap, cctx_T *cctx)
 	    generate_instr_type(cctx, ISN_REDIREND, &t_string);
 
 	    if (lhs->lhs_append)
-		generate_instr_drop(cctx, ISN_CONCAT, 1);
+		generate_CONCAT(cctx, 2);
 
 	    if (lhs->lhs_has_index)
 	    {
@@ -9051,6 +9107,116 @@ add_def_function(ufunc_T *ufunc)
     return OK;
 }
 
+/*
+ * Return the number of instructions from "isn", with "count" available, that
+ * a superinstruction can execute: a LOAD, then LOADs, constants and
+ * operations on numbers, or on floats, then a STORE or JUMP_IF_FALSE of the
+ * result of the last operation.  All loaded values are used by an operation,
+ * thus they must have the type of the operations.
+ * Sets "*is_float" when the operations are on floats.
+ * Returns zero when the instructions don't match.
+ */
+    static int
+fused_length(isn_T *isn, int count, int *is_float)
+{
+    vartype_T	kind = VAR_UNKNOWN;
+    int		depth = 0;
+    int		idx;
+
+    for (idx = 0; idx < count; ++idx)
+    {
+	isntype_T   type = isn[idx].isn_type;
+	isntype_T   prev_type = idx == 0 ? ISN_LOAD : isn[idx - 1].isn_type;
+	vartype_T   vartype = VAR_UNKNOWN;
+
+	if (idx == 0 && type != ISN_LOAD)
+	    return 0;
+	// a comparison must be the last operation
+	if ((prev_type == ISN_COMPARENR || prev_type == ISN_COMPAREFLOAT)
+				       && type != ISN_STORE && type != ISN_JUMP)
+	    return 0;
+
+	switch (type)
+	{
+	    case ISN_LOAD:
+	    case ISN_PUSHNR:
+#ifdef FEAT_FLOAT
+	    case ISN_PUSHF:
+#endif
+		if (++depth > FUSED_REG_COUNT)
+		    return 0;
+		if (type != ISN_LOAD)
+		    vartype = type == ISN_PUSHNR ? VAR_NUMBER : VAR_FLOAT;
+		break;
+
+	    case ISN_OPNR:
+	    case ISN_COMPARENR:
+#ifdef FEAT_FLOAT
+	    case ISN_OPFLOAT:
+	    case ISN_COMPAREFLOAT:
+#endif
+		if (--depth < 1)
+		    return 0;
+		vartype = type == ISN_OPNR || type == ISN_COMPARENR
+						       ? VAR_NUMBER : VAR_FLOAT;
+		break;
+
+	    case ISN_STORE:
+	    case ISN_JUMP:
+		if (depth != 1 || (prev_type != ISN_OPNR
+			    && prev_type != ISN_COMPARENR
+			    && prev_type != ISN_OPFLOAT
+			    && prev_type != ISN_COMPAREFLOAT))
+		    return 0;
+		if (type == ISN_JUMP && (isn[idx].isn_arg.jump.jump_when
+							       != JUMP_IF_FALSE
+			    || (prev_type != ISN_COMPARENR
+					   && prev_type != ISN_COMPAREFLOAT)))
+		    return 0;
+		*is_float = kind == VAR_FLOAT;
+		return idx + 1;
+
+	    default:
+		return 0;
+	}
+
+	if (vartype != VAR_UNKNOWN)
+	{
+	    if (kind != VAR_UNKNOWN && kind != vartype)
+		return 0;
+	    kind = vartype;
+	}
+    }
+    return 0;
+}
+
+/*
+ * Replace the LOAD that starts an often used sequence in "instr" with a
+ * superinstruction that executes the whole sequence at once, keeping numbers
+ * and floats in registers instead of typval_T on the stack.  E.g.
+ * "total = total + i * 2" and "while i < n".  The other instructions are
+ * kept, a jump may go to one of them, and the disassembly still shows them.
+ */
+    static void
+fuse_instructions(garray_T *instr)
+{
+    isn_T   *isn = (isn_T *)instr->ga_data;
+    int	    idx;
+    int	    len;
+    int	    is_float;
+
+    for (idx = 0; idx < instr->ga_len; ++idx)
+    {
+	len = fused_length(isn + idx, instr->ga_len - idx, &is_float);
+	if (len > 0)
+	{
+	    isn[idx].isn_type = is_float ? ISN_LOAD_EXPRFLOAT
+							     : ISN_LOAD_EXPRNR;
+	    idx += len - 1;
+	}
+    }
+}
+
 /*
  * After ex_function() has collected all the function lines: parse and compile
  * the lines into instructions.
@@ -9741,6 +9907,7 @@ nextline:
 							 + ufunc->uf_dfunc_idx;
 	dfunc->df_deleted = FALSE;
 	dfunc->df_script_seq = current_sctx.sc_seq;
+	fuse_instructions(instr);
 #ifdef FEAT_PROFILE
 	if (cctx.ctx_compile_type == CT_PROFILE)
 	{
@@ -9870,6 +10037,18 @@ set_function_type(ufunc_T *ufunc)
 					   argcount, &ufunc->uf_type_list);
 }
 
+/*
+ * Free an inline cache allocated with alloc_funccache().
+ */
+    static void
+free_funccache(funccache_T *fc)
+{
+    if (fc != NULL)
+    {
+	vim_free(fc->fc_name);
+	vim_free(fc);
+    }
+}
 
 /*
  * Delete an instruction, free what it contains.
@@ -9958,7 +10137,11 @@ delete_instr(isn_T *isn)
 	    break;
 
 	case ISN_UCALL:
-	    vim_free(isn->isn_arg.ufunc.cuf_name);
+	    free_funccache(isn->isn_arg.ufunc.cuf_cache);
+	    break;
+
+	case ISN_PCALL:
+	    free_funccache(isn->isn_arg.pfunc.cpf_cache);
 	    break;
 
 	case ISN_FUNCREF:
@@ -10070,6 +10253,8 @@ delete_instr(isn_T *isn)
 	case ISN_LISTINDEX:
 	case ISN_LISTSLICE:
 	case ISN_LOAD:
+	case ISN_LOAD_EXPRFLOAT:
+	case ISN_LOAD_EXPRNR:
 	case ISN_LOADBDICT:
 	case ISN_LOADGDICT:
 	case ISN_LOADOUTER:
@@ -10085,7 +10270,6 @@ delete_instr(isn_T *isn)
 	case ISN_OPANY:
 	case ISN_OPFLOAT:
 	case ISN_OPNR:
-	case ISN_PCALL:
 	case ISN_PCALL_END:
 	case ISN_PROF_END:
 	case ISN_PROF_START:
@@ -852,10 +852,26 @@ vim9_aborting(int prev_called_emsg)
     return called_emsg > prev_called_emsg || got_int || did_throw;
 }
 
+/*
+ * Return the function stored in inline cache "fc" if it can still be used.
+ * Returns NULL when nothing was cached or functions were defined or deleted
+ * since then.
+ */
+    static ufunc_T *
+funccache_lookup(funccache_T *fc)
+{
+    if (fc->fc_ufunc != NULL && fc->fc_changed == func_hashtab_changed()
+				  && (fc->fc_ufunc->uf_flags & FC_DEAD) == 0)
+	return fc->fc_ufunc;
+    return NULL;
+}
+
 /*
  * Execute a function by "name".
  * This can be a builtin function or a user function.
  * "iptr" can be used to replace the instruction with a more efficient one.
+ * When "fc" is not NULL it is used to avoid looking up "name" again, and
+ * updated when the lookup was done.
  * Returns FAIL if not found without an error message.
  */
     static int
@@ -863,32 +879,42 @@ call_by_name(
 	char_u	    *name,
 	int	    argcount,
 	ectx_T	    *ectx,
-	isn_T	    *iptr)
+	isn_T	    *iptr,
+	funccache_T *fc)
 {
-    ufunc_T *ufunc;
+    ufunc_T *ufunc = fc == NULL ? NULL : funccache_lookup(fc);
 
-    if (builtin_function(name, -1))
+    if (ufunc == NULL)
     {
-	int func_idx = find_internal_func(name);
+	if (builtin_function(name, -1))
+	{
+	    int func_idx = find_internal_func(name);
 
-	if (func_idx < 0)
-	    return FAIL;
-	if (check_internal_func(func_idx, argcount) < 0)
-	    return FAIL;
-	return call_bfunc(func_idx, argcount, ectx);
-    }
+	    if (func_idx < 0)
+		return FAIL;
+	    if (check_internal_func(func_idx, argcount) < 0)
+		return FAIL;
+	    return call_bfunc(func_idx, argcount, ectx);
+	}
 
-    ufunc = find_func(name, FALSE, NULL);
+	ufunc = find_func(name, FALSE, NULL);
 
-    if (ufunc == NULL)
-    {
-	int called_emsg_before = called_emsg;
+	if (ufunc == NULL)
+	{
+	    int called_emsg_before = called_emsg;
+
+	    if (script_autoload(name, TRUE))
+		// loaded a package, search for the function again
+		ufunc = find_func(name, FALSE, NULL);
+	    if (vim9_aborting(called_emsg_before))
+		return FAIL;  // bail out if loading the script caused an error
+	}
 
-	if (script_autoload(name, TRUE))
-	    // loaded a package, search for the function again
-	    ufunc = find_func(name, FALSE, NULL);
-	if (vim9_aborting(called_emsg_before))
-	    return FAIL;  // bail out if loading the script caused an error
+	if (fc != NULL)
+	{
+	    fc->fc_ufunc = ufunc;
+	    fc->fc_changed = func_hashtab_changed();
+	}
     }
 
     if (ufunc != NULL)
@@ -920,11 +946,18 @@ call_by_name(
     return FAIL;
 }
 
+/*
+ * Call the funcref or partial "tv".
+ * When "pcache" is not NULL it is used to remember the function found for the
+ * name of a funcref, so that calling it again does not need a lookup.  Only
+ * the last name is remembered.
+ */
     static int
 call_partial(
 	typval_T    *tv,
 	int	    argcount_arg,
-	ectx_T	    *ectx)
+	ectx_T	    *ectx,
+	funccache_T **pcache)
 {
     int		argcount = argcount_arg;
     char_u	*name = NULL;
@@ -965,14 +998,41 @@ call_partial(
 	char_u	*tofree = NULL;
 	int	error = FCERR_NONE;
 	char_u	*fname;
+	funccache_T *fc = NULL;
 
-	// May need to translate <SNR>123_ to K_SNR.
-	fname = fname_trans_sid(name, fname_buf, &tofree, &error);
-	if (error != FCERR_NONE)
-	    res = FAIL;
+	if (pcache != NULL)
+	{
+	    fc = *pcache;
+	    if (fc == NULL)
+	    {
+		fc = ALLOC_CLEAR_ONE(funccache_T);
+		*pcache = fc;
+	    }
+	    if (fc != NULL && (fc->fc_name == NULL
+					    || STRCMP(fc->fc_name, name) != 0))
+	    {
+		// Called with another name, forget about the previous one.
+		vim_free(fc->fc_name);
+		fc->fc_name = vim_strsave(name);
+		fc->fc_ufunc = NULL;
+		if (fc->fc_name == NULL)
+		    fc = NULL;
+	    }
+	}
+
+	if (fc != NULL && funccache_lookup(fc) != NULL)
+	    // Same name as last time and the function is still valid.
+	    res = call_by_name(name, argcount, ectx, NULL, fc);
 	else
-	    res = call_by_name(fname, argcount, ectx, NULL);
-	vim_free(tofree);
+	{
+	    // May need to translate <SNR>123_ to K_SNR.
+	    fname = fname_trans_sid(name, fname_buf, &tofree, &error);
+	    if (error != FCERR_NONE)
+		res = FAIL;
+	    else
+		res = call_by_name(fname, argcount, ectx, NULL, fc);
+	    vim_free(tofree);
+	}
     }
 
     if (res == FAIL)
@@ -1302,21 +1362,22 @@ get_split_sourceline(
 }
 
 /*
- * Execute a function by "name".
+ * Execute a function by the name in "fc".
  * This can be a builtin function, user function or a funcref.
  * "iptr" can be used to replace the instruction with a more efficient one.
  */
     static int
 call_eval_func(
-	char_u	    *name,
+	funccache_T *fc,
 	int	    argcount,
 	ectx_T	    *ectx,
 	isn_T	    *iptr)
 {
+    char_u  *name = fc->fc_name;
     int	    called_emsg_before = called_emsg;
     int	    res;
 
-    res = call_by_name(name, argcount, ectx, iptr);
+    res = call_by_name(name, argcount, ectx, iptr, fc);
     if (res == FAIL && called_emsg == called_emsg_before)
     {
 	dictitem_T	*v;
@@ -1332,7 +1393,7 @@ call_eval_func(
 	    semsg(_(e_unknownfunc), name);
 	    return FAIL;
 	}
-	return call_partial(&v->di_tv, argcount, ectx);
+	return call_partial(&v->di_tv, argcount, ectx, NULL);
     }
     return res;
 }
@@ -1519,6 +1580,56 @@ handle_debug(isn_T *iptr, ectx_T *ectx)
 	vim_free(line);
 }
 
+/*
+ * Compute "arg1 op arg2" for ISN_OPNR and ISN_COMPARENR.
+ */
+    static varnumber_T
+exec_opnr(exprtype_T op, varnumber_T arg1, varnumber_T arg2)
+{
+    switch (op)
+    {
+	case EXPR_MULT: return arg1 * arg2;
+	case EXPR_DIV: return arg1 / arg2;
+	case EXPR_REM: return arg1 % arg2;
+	case EXPR_SUB: return arg1 - arg2;
+	case EXPR_ADD: return arg1 + arg2;
+
+	case EXPR_EQUAL: return arg1 == arg2;
+	case EXPR_NEQUAL: return arg1 != arg2;
+	case EXPR_GREATER: return arg1 > arg2;
+	case EXPR_GEQUAL: return arg1 >= arg2;
+	case EXPR_SMALLER: return arg1 < arg2;
+	case EXPR_SEQUAL: return arg1 <= arg2;
+	default: return 0;
+    }
+}
+
+#ifdef FEAT_FLOAT
+/*
+ * Compute "arg1 op arg2" for ISN_OPFLOAT and ISN_COMPAREFLOAT.  A comparison
+ * results in one or zero.
+ */
+    static float_T
+exec_opfloat(exprtype_T op, float_T arg1, float_T arg2)
+{
+    switch (op)
+    {
+	case EXPR_MULT: return arg1 * arg2;
+	case EXPR_DIV: return arg1 / arg2;
+	case EXPR_SUB: return arg1 - arg2;
+	case EXPR_ADD: return arg1 + arg2;
+
+	case EXPR_EQUAL: return arg1 == arg2;
+	case EXPR_NEQUAL: return arg1 != arg2;
+	case EXPR_GREATER: return arg1 > arg2;
+	case EXPR_GEQUAL: return arg1 >= arg2;
+	case EXPR_SMALLER: return arg1 < arg2;
+	case EXPR_SEQUAL: return arg1 <= arg2;
+	default: return 0;
+    }
+}
+#endif
+
 /*
  * Execute instructions in execution context "ectx".
  * Return OK or FAIL;
@@ -2882,7 +2993,8 @@ exec_instructions(ectx_T *ectx)
 			partial_tv = *STACK_TV_BOT(0);
 			tv = &partial_tv;
 		    }
-		    r = call_partial(tv, pfunc->cpf_argcount, ectx);
+		    r = call_partial(tv, pfunc->cpf_argcount, ectx,
+							  &pfunc->cpf_cache);
 		    if (tv == &partial_tv)
 			clear_tv(&partial_tv);
 		    if (r == FAIL)
@@ -2905,7 +3017,7 @@ exec_instructions(ectx_T *ectx)
 		    cufunc_T	*cufunc = &iptr->isn_arg.ufunc;
 
 		    SOURCING_LNUM = iptr->isn_lnum;
-		    if (call_eval_func(cufunc->cuf_name, cufunc->cuf_argcount,
+		    if (call_eval_func(cufunc->cuf_cache, cufunc->cuf_argcount,
 							   ectx, iptr) == FAIL)
 			goto on_error;
 		}
@@ -3370,26 +3482,8 @@ exec_instructions(ectx_T *ectx)
 		{
 		    typval_T	*tv1 = STACK_TV_BOT(-2);
 		    typval_T	*tv2 = STACK_TV_BOT(-1);
-		    varnumber_T arg1 = tv1->vval.v_number;
-		    varnumber_T arg2 = tv2->vval.v_number;
-		    varnumber_T res;
-
-		    switch (iptr->isn_arg.op.op_type)
-		    {
-			case EXPR_MULT: res = arg1 * arg2; break;
-			case EXPR_DIV: res = arg1 / arg2; break;
-			case EXPR_REM: res = arg1 % arg2; break;
-			case EXPR_SUB: res = arg1 - arg2; break;
-			case EXPR_ADD: res = arg1 + arg2; break;
-
-			case EXPR_EQUAL: res = arg1 == arg2; break;
-			case EXPR_NEQUAL: res = arg1 != arg2; break;
-			case EXPR_GREATER: res = arg1 > arg2; break;
-			case EXPR_GEQUAL: res = arg1 >= arg2; break;
-			case EXPR_SMALLER: res = arg1 < arg2; break;
-			case EXPR_SEQUAL: res = arg1 <= arg2; break;
-			default: res = 0; break;
-		    }
+		    varnumber_T res = exec_opnr(iptr->isn_arg.op.op_type,
+				       tv1->vval.v_number, tv2->vval.v_number);
 
 		    --ectx->ec_stack.ga_len;
 		    if (iptr->isn_type == ISN_COMPARENR)
@@ -3402,6 +3496,129 @@ exec_instructions(ectx_T *ectx)
 		}
 		break;
 
+	    // Superinstructions: execute this and the following instructions
+	    // up to a STORE or JUMP, keeping values in registers instead of on
+	    // the stack.  See fused_length() for what they can be.
+	    case ISN_LOAD_EXPRNR:
+		{
+		    varnumber_T	reg[FUSED_REG_COUNT];
+		    int		depth = 0;
+		    int		is_bool = FALSE;
+		    isn_T	*ip;
+
+		    if (iptr[3].isn_type == ISN_STORE
+					       || iptr[3].isn_type == ISN_JUMP)
+		    {
+			// Short sequence: LOAD, LOAD or PUSHNR, operation.
+			reg[0] = exec_opnr(iptr[2].isn_arg.op.op_type,
+			      STACK_TV_VAR(iptr->isn_arg.number)->vval.v_number,
+			      iptr[1].isn_type == ISN_PUSHNR
+				? iptr[1].isn_arg.number
+				: STACK_TV_VAR(iptr[1].isn_arg.number)
+							      ->vval.v_number);
+			is_bool = iptr[2].isn_type == ISN_COMPARENR;
+			ip = iptr + 3;
+		    }
+		    else for (ip = iptr; ; ++ip)
+		    {
+			if (ip->isn_type == ISN_PUSHNR)
+			    reg[depth++] = ip->isn_arg.number;
+			else if (ip->isn_type == ISN_OPNR
+					       || ip->isn_type == ISN_COMPARENR)
+			{
+			    --depth;
+			    reg[depth - 1] = exec_opnr(ip->isn_arg.op.op_type,
+						 reg[depth - 1], reg[depth]);
+			    is_bool = ip->isn_type == ISN_COMPARENR;
+			}
+			else if (ip->isn_type == ISN_STORE
+						   || ip->isn_type == ISN_JUMP)
+			    break;
+			else  // ISN_LOAD
+			    reg[depth++] = STACK_TV_VAR(ip->isn_arg.number)
+							       ->vval.v_number;
+		    }
+
+		    ectx->ec_iidx = (int)(ip - ectx->ec_instr) + 1;
+		    if (ip->isn_type == ISN_JUMP)
+		    {
+			if (!reg[0])
+			    ectx->ec_iidx = ip->isn_arg.jump.jump_where;
+		    }
+		    else
+		    {
+			tv = STACK_TV_VAR(ip->isn_arg.number);
+			clear_tv(tv);
+			tv->v_lock = 0;
+			if (is_bool)
+			{
+			    tv->v_type = VAR_BOOL;
+			    tv->vval.v_number = reg[0] ? VVAL_TRUE : VVAL_FALSE;
+			}
+			else
+			{
+			    tv->v_type = VAR_NUMBER;
+			    tv->vval.v_number = reg[0];
+			}
+		    }
+		}
+		break;
+
+	    case ISN_LOAD_EXPRFLOAT:
+#ifdef FEAT_FLOAT
+		{
+		    float_T	reg[FUSED_REG_COUNT];
+		    int		depth = 0;
+		    int		is_bool = FALSE;
+		    isn_T	*ip;
+
+		    for (ip = iptr; ; ++ip)
+		    {
+			if (ip->isn_type == ISN_PUSHF)
+			    reg[depth++] = ip->isn_arg.fnumber;
+			else if (ip->isn_type == ISN_OPFLOAT
+					    || ip->isn_type == ISN_COMPAREFLOAT)
+			{
+			    --depth;
+			    reg[depth - 1] = exec_opfloat(ip->isn_arg.op.op_type,
+						 reg[depth - 1], reg[depth]);
+			    is_bool = ip->isn_type == ISN_COMPAREFLOAT;
+			}
+			else if (ip->isn_type == ISN_STORE
+						   || ip->isn_type == ISN_JUMP)
+			    break;
+			else  // ISN_LOAD
+			    reg[depth++] = STACK_TV_VAR(ip->isn_arg.number)
+								->vval.v_float;
+		    }
+
+		    ectx->ec_iidx = (int)(ip - ectx->ec_instr) + 1;
+		    if (ip->isn_type == ISN_JUMP)
+		    {
+			if (reg[0] == 0)
+			    ectx->ec_iidx = ip->isn_arg.jump.jump_where;
+		    }
+		    else
+		    {
+			tv = STACK_TV_VAR(ip->isn_arg.number);
+			clear_tv(tv);
+			tv->v_lock = 0;
+			if (is_bool)
+			{
+			    tv->v_type = VAR_BOOL;
+			    tv->vval.v_number = reg[0] != 0
+						       ? VVAL_TRUE : VVAL_FALSE;
+			}
+			else
+			{
+			    tv->v_type = VAR_FLOAT;
+			    tv->vval.v_float = reg[0];
+			}
+		    }
+		}
+#endif
+		break;
+
 	    // Computation with two float arguments
 	    case ISN_OPFLOAT:
 	    case ISN_COMPAREFLOAT:
@@ -3409,31 +3626,14 @@ exec_instructions(ectx_T *ectx)
 		{
 		    typval_T	*tv1 = STACK_TV_BOT(-2);
 		    typval_T	*tv2 = STACK_TV_BOT(-1);
-		    float_T	arg1 = tv1->vval.v_float;
-		    float_T	arg2 = tv2->vval.v_float;
-		    float_T	res = 0;
-		    int		cmp = FALSE;
+		    float_T	res = exec_opfloat(iptr->isn_arg.op.op_type,
+					 tv1->vval.v_float, tv2->vval.v_float);
 
-		    switch (iptr->isn_arg.op.op_type)
-		    {
-			case EXPR_MULT: res = arg1 * arg2; break;
-			case EXPR_DIV: res = arg1 / arg2; break;
-			case EXPR_SUB: res = arg1 - arg2; break;
-			case EXPR_ADD: res = arg1 + arg2; break;
-
-			case EXPR_EQUAL: cmp = arg1 == arg2; break;
-			case EXPR_NEQUAL: cmp = arg1 != arg2; break;
-			case EXPR_GREATER: cmp = arg1 > arg2; break;
-			case EXPR_GEQUAL: cmp = arg1 >= arg2; break;
-			case EXPR_SMALLER: cmp = arg1 < arg2; break;
-			case EXPR_SEQUAL: cmp = arg1 <= arg2; break;
-			default: cmp = 0; break;
-		    }
 		    --ectx->ec_stack.ga_len;
 		    if (iptr->isn_type == ISN_COMPAREFLOAT)
 		    {
 			tv1->v_type = VAR_BOOL;
-			tv1->vval.v_number = cmp ? VVAL_TRUE : VVAL_FALSE;
+			tv1->vval.v_number = res != 0 ? VVAL_TRUE : VVAL_FALSE;
 		    }
 		    else
 			tv1->vval.v_float = res;
@@ -3683,15 +3883,46 @@ exec_instructions(ectx_T *ectx)
 
 	    case ISN_CONCAT:
 		{
-		    char_u *str1 = STACK_TV_BOT(-2)->vval.v_string;
-		    char_u *str2 = STACK_TV_BOT(-1)->vval.v_string;
-		    char_u *res;
+		    int		count = (int)iptr->isn_arg.number;
+		    typval_T	*first = STACK_TV_BOT(-count);
+		    size_t	len = 0;
+		    char_u	*res;
+		    char_u	*str;
+		    int		idx;
 
-		    res = concat_str(str1, str2);
-		    clear_tv(STACK_TV_BOT(-2));
-		    clear_tv(STACK_TV_BOT(-1));
-		    --ectx->ec_stack.ga_len;
-		    STACK_TV_BOT(-1)->vval.v_string = res;
+		    for (idx = 0; idx < count; ++idx)
+			if (first[idx].vval.v_string != NULL)
+			    len += STRLEN(first[idx].vval.v_string);
+
+		    // The first string belongs to the stack, make it longer
+		    // instead of allocating a new one.
+		    str = first->vval.v_string;
+		    if (str == NULL)
+			res = alloc(len + 1);
+		    else
+		    {
+			res = vim_realloc(str, len + 1);
+			if (res == NULL)
+			    vim_free(str);
+		    }
+		    if (res != NULL)
+		    {
+			len = str == NULL ? 0 : STRLEN(res);
+			for (idx = 1; idx < count; ++idx)
+			{
+			    str = first[idx].vval.v_string;
+			    if (str != NULL)
+			    {
+				STRCPY(res + len, str);
+				len += STRLEN(str);
+			    }
+			}
+			res[len] = NUL;
+		    }
+		    for (idx = 1; idx < count; ++idx)
+			clear_tv(first + idx);
+		    ectx->ec_stack.ga_len -= count - 1;
+		    first->vval.v_string = res;
 		}
 		break;
 
@@ -4854,6 +5085,9 @@ list_instructions(char *pfx, isn_T *instr, int instr_count, ufunc_T *ufunc)
 					    (varnumber_T)(iptr->isn_arg.number));
 		break;
 	    case ISN_LOAD:
+	    // a superinstruction is listed as the instructions it replaces
+	    case ISN_LOAD_EXPRNR:
+	    case ISN_LOAD_EXPRFLOAT:
 		{
 		    if (iptr->isn_arg.number < 0)
 			smsg("%s%4d LOAD arg[%lld]", pfx, current,
@@ -5144,7 +5378,7 @@ list_instructions(char *pfx, isn_T *instr, int instr_count, ufunc_T *ufunc)
 		    cufunc_T	*cufunc = &iptr->isn_arg.ufunc;
 
 		    smsg("%s%4d UCALL %s(argc %d)", pfx, current,
-				       cufunc->cuf_name, cufunc->cuf_argcount);
+			 cufunc->cuf_cache->fc_name, cufunc->cuf_argcount);
 		}
 		break;
 	    case ISN_PCALL:
@@ -5363,7 +5597,10 @@ list_instructions(char *pfx, isn_T *instr, int instr_count, ufunc_T *ufunc)
 	    case ISN_ADDBLOB: smsg("%s%4d ADDBLOB", pfx, current); break;
 
 	    // expression operations
-	    case ISN_CONCAT: smsg("%s%4d CONCAT", pfx, current); break;
+	    case ISN_CONCAT:
+		smsg("%s%4d CONCAT size %lld", pfx, current,
+					      (varnumber_T)iptr->isn_arg.number);
+		break;
 	    case ISN_STRINDEX: smsg("%s%4d STRINDEX", pfx, current); break;
 	    case ISN_STRSLICE: smsg("%s%4d STRSLICE", pfx, current); break;
 	    case ISN_BLOBINDEX: smsg("%s%4d BLOBINDEX", pfx, current); break;